@@ -289,12 +289,16 @@ void Editor::Draw()
         engineMode == EngineMode::Play ? "MODE: PLAY" : "MODE: EDITOR"
     );
 
+    if (compMgr->AnyChangedSince(savedTick))
+        ImGui::TextDisabled("Unsaved changes");
+
 
     ImGuiIO& io = ImGui::GetIO();
 
     if (io.KeyCtrl && ImGui::IsKeyPressed(ImGuiKey_S))
     {
         SceneSerializer::Save(project.scenePath.string(), *entityMgr, *compMgr, meta);
+        MarkSceneSaved();
         statusText = "Scene Saved!";
         statusTimer = 2.0f; // show for 2 seconds
     }
@@ -302,6 +306,7 @@ void Editor::Draw()
     if (io.KeyCtrl && ImGui::IsKeyPressed(ImGuiKey_O))
     {
         SceneSerializer::Load(project.scenePath.string(), *entityMgr, *compMgr, meta);
+        MarkSceneSaved();
         statusText = "Scene Loaded!";
         statusTimer = 2.0f;
     }
@@ -313,25 +318,28 @@ void Editor::Draw()
         {
             if (ImGui::MenuItem("New Scene"))
             {
-                // Clear everything
-                for (uint32_t id = 0; id < 10000; ++id)
+                // Clear everything (copy: destroying reorders the living list)
+                const std::vector<Entity> living = entityMgr->GetLivingEntities();
+                for (Entity e : living)
                 {
-                    Entity e{ id };
-                    if (entityMgr->IsAlive(e))
-                    {
-                        compMgr->RemoveComponent<TransformComponent>(e);
-                        entityMgr->DestroyEntity(e);
-                        meta.Remove(e);
-                    }
+                    compMgr->EntityDestroyed(e);
+                    entityMgr->DestroyEntity(e);
+                    meta.Remove(e);
                 }
                 selectedEntity = {};
             }
 
             if (ImGui::MenuItem("Save Scene", "Ctrl+S"))
+            {
                 SceneSerializer::Save(project.scenePath.string(), *entityMgr, *compMgr, meta);
+                MarkSceneSaved();
+            }
 
             if (ImGui::MenuItem("Load Scene", "Ctrl+O"))
+            {
                 SceneSerializer::Load(project.scenePath.string(), *entityMgr, *compMgr, meta);
+                MarkSceneSaved();
+            }
 
             if (ImGui::MenuItem("Close Project"))
             {
@@ -368,7 +376,7 @@ void Editor::Draw()
 
                 if (ImGui::MenuItem("Delete Selected"))
                 {
-                    compMgr->RemoveComponent<TransformComponent>(selectedEntity);
+                    compMgr->EntityDestroyed(selectedEntity);
                     entityMgr->DestroyEntity(selectedEntity);
                     meta.Remove(selectedEntity);
                     selectedEntity = {};
@@ -518,11 +526,8 @@ void Editor::DrawSceneView()
             float closestT = FLT_MAX;
             Entity closestEntity;
 
-            for (uint32_t id = 0; id < 10000; ++id)
+            for (Entity e : entityMgr->GetLivingEntities())
             {
-                Entity e{ id };
-                if (!entityMgr->IsAlive(e)) continue;
-
                 try {
                     const auto& t = compMgr->GetComponent<TransformComponent>(e);
                     glm::vec3 pos(t.position.x, t.position.y, t.position.z);
@@ -621,6 +626,7 @@ void Editor::DrawSceneView()
             transform.position = { trans.x, trans.y, trans.z };
             transform.rotation = { rot.x, rot.y, rot.z };
             transform.scale = { scl.x, scl.y, scl.z };
+            compMgr->MarkChanged<TransformComponent>(selectedEntity);
         }
 
         // Optional HUD
@@ -689,11 +695,9 @@ void Editor::DrawHierarchy()
 
     ImGui::Separator();
 
-    for (uint32_t id = 0; id < 10000; ++id)
+    // Slot order keeps the list stable when entities are deleted
+    entityMgr->ForEachAlive([&](Entity e)
     {
-        Entity e{ id };
-        if (!entityMgr->IsAlive(e)) continue;
-
         std::string& name = meta.names.count(e.id)
             ? meta.names[e.id]
             : meta.names[e.id] = "Entity " + std::to_string(e.id);
@@ -757,7 +761,7 @@ void Editor::DrawHierarchy()
 
             if (ImGui::MenuItem("Delete"))
             {
-                compMgr->RemoveComponent<TransformComponent>(e);
+                compMgr->EntityDestroyed(e);
                 entityMgr->DestroyEntity(e);
                 meta.Remove(e);
                 if (selectedEntity.id == e.id) selectedEntity = {};
@@ -765,7 +769,7 @@ void Editor::DrawHierarchy()
 
             ImGui::EndPopup();
         }
-    }
+    });
 
 
     ImGui::End();
@@ -801,9 +805,11 @@ void Editor::DrawDetails()
             compMgr->GetComponent<TransformComponent>(selectedEntity);
 
         ImGui::SeparatorText("Transform");
-        ImGui::DragFloat3("Position", &transform.position.x, 0.1f);
-        ImGui::DragFloat3("Rotation", &transform.rotation.x, 0.1f);
-        ImGui::DragFloat3("Scale", &transform.scale.x, 0.1f, 0.01f, 10.0f);
+        bool edited = ImGui::DragFloat3("Position", &transform.position.x, 0.1f);
+        edited |= ImGui::DragFloat3("Rotation", &transform.rotation.x, 0.1f);
+        edited |= ImGui::DragFloat3("Scale", &transform.scale.x, 0.1f, 0.01f, 10.0f);
+        if (edited)
+            compMgr->MarkChanged<TransformComponent>(selectedEntity);
     }
 
     // ---------------- Asset info ----------------
@@ -1354,6 +1360,13 @@ void Editor::BeginDockSpace()
     ImGui::End();
 }
 
+void Editor::MarkSceneSaved()
+{
+    // Start a fresh tick so the save/load's own inserts don't count
+    compMgr->AdvanceTick();
+    savedTick = compMgr->GetTick();
+}
+
 void Editor::TogglePlayMode()
 {
     if (engineMode == EngineMode::Editor)
@@ -1399,10 +1412,8 @@ void Editor::EnterPlayMode()
     std::cout << std::filesystem::current_path() << "\n";
 
 
-    for (EntityID id = 0; id < entityMgr->GetMaxEntities(); ++id)
+    for (Entity e : entityMgr->GetLivingEntities())
     {
-        Entity e{ id };
-        if (!entityMgr->IsAlive(e)) continue;
         if (compMgr->HasComponent<ScriptComponent>(e))
             scriptCount++;
     }
@@ -1410,10 +1421,8 @@ void Editor::EnterPlayMode()
     std::cout << "[ScriptSystem] Script components found: "
         << scriptCount << "\n";
 
-    for (EntityID id = 0; id < entityMgr->GetMaxEntities(); ++id)
+    for (Entity e : entityMgr->GetLivingEntities())
     {
-        Entity e{ id };
-        if (!entityMgr->IsAlive(e)) continue;
         if (!compMgr->HasComponent<ScriptComponent>(e)) continue;
 
         auto& sc = compMgr->GetComponent<ScriptComponent>(e);
@@ -78,6 +78,10 @@ private:
     Entity selectedEntity;
     EntityMeta meta;
 	Entity renamingEntity;
+    uint32_t savedTick = 0;   // component tick right after the last save/load
+
+    // Scene counts as unsaved once any component changes after this
+    void MarkSceneSaved();
 
     void DrawSceneView();
     void DrawHierarchy();
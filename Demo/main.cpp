@@ -7,8 +7,12 @@
 #include "../Engine/Core/Memory/LinearAllocator.h"
 #include "../Engine/Core/Memory/StackAllocator.h"
 #include "../Engine/Core/Memory/PoolAllocator.h"
+#include "../Engine/Core/Memory/SlabAllocator.h"
+#include "../Engine/Core/Memory/FrameArena.h"
+#include "../Engine/Core/Memory/HeapCounter.h"
 #include "../Engine/ConfigReader.h"
 #include "../Engine/ProfilerOverlay.h"
+#include "../Engine/Profiler.h"
 #include "../Engine/JobSystem.h"
 
 #include "../Engine/ECS/EntityManager.h"
@@ -47,6 +51,7 @@
 #include "../Engine/Systems/PlayerControllerSystem.h"
 #include "../Engine/Components/CameraFollowComponent.h"
 #include "../Engine/Systems/CameraControllerSystem.h"
+#include "../Engine/Systems/SystemGraph.h"
 #include "../Engine/Components/ColliderComponent.h"
 
 // ------------------------------------------------------------
@@ -58,6 +63,7 @@ Allocator* createAllocator(const std::unordered_map<std::string, std::string>& c
     if (type == "Stack")   return new StackAllocator(std::stoull(config.at("block_size")));
     if (type == "Pool")    return new PoolAllocator(std::stoull(config.at("block_size")),
         std::stoull(config.at("num_blocks")));
+    if (type == "Slab")    return new SlabAllocator();
     return nullptr;
 }
 
@@ -142,9 +148,52 @@ int main() {
     auto config = loadConfig("../Tests/engine.cfg");
     Allocator* allocator = createAllocator(config);
     ProfilerOverlay profiler(allocator);
-    JobSystem jobSystem(std::thread::hardware_concurrency() - 1);
 
-    EntityManager entities(64);
+    // Scratch for per-frame temporaries (draw lists etc.), on every thread
+    FrameArena frameArena(config.count("frame_arena_kb") ? std::stoull(config.at("frame_arena_kb")) * 1024 : FrameArena::DefaultBlockBytes);
+    renderer.SetFrameArena(&frameArena);
+    // Main thread helps in Wait, so no core is left idle; the I/O lane
+    // mostly sleeps in blocking loads
+    ThreadPool::Config ioDefaults;
+    ioDefaults.threadCount = 2;
+    ioDefaults.name = "IO";
+    JobSystem jobSystem(ThreadPool::Config::Load(config, "worker"), ThreadPool::Config::Load(config, "io", ioDefaults));
+
+    // Per-task timestamps cost two clock reads per job, so opt-in
+    bool showProfiler = config.count("show_profiler_overlay") && config.at("show_profiler_overlay") == "true";
+    jobSystem.SetTracing(config.count("job_tracing") && config.at("job_tracing") == "true");
+    std::vector<ThreadPool::WorkerStats> jobStats;
+    std::vector<ThreadPool::TraceEvent> jobTrace;
+
+    // CPU zones for chrome://tracing. With profiler_spike_ms set, the
+    // trace is written when the first frame over that budget ends (the
+    // rings still hold the frames before it); otherwise at exit.
+    Profiler::SetThreadName("Main");
+    Profiler::SetEnabled(config.count("profiler_zones") && config.at("profiler_zones") == "true");
+    std::string traceFile = config.count("profiler_trace_file") ? config.at("profiler_trace_file") : "profile.json";
+    float spikeMs = 0.0f;
+    if (config.count("profiler_spike_ms"))
+    {
+        try
+        {
+            spikeMs = std::stof(config.at("profiler_spike_ms"));
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "[Profiler] Invalid profiler_spike_ms in config: " << config.at("profiler_spike_ms") << "\n";
+        }
+    }
+    bool traceWritten = false;
+    float frameMs = 0.0f;
+    auto writeTrace = [&](const char* reason) {
+        if (Profiler::WriteChromeTrace(traceFile))
+            std::cout << "[Profiler] Wrote " << traceFile << " (" << reason << ")\n";
+        else
+            std::cerr << "[Profiler] Could not write " << traceFile << "\n";
+        traceWritten = true;
+    };
+
+    EntityManager entities;
     ComponentManager components;
     components.RegisterComponent<TransformComponent>("TransformComponent");
     components.RegisterComponent<PhysicsComponent>("PhysicsComponent");
@@ -224,11 +273,50 @@ int main() {
 
     Editor editor(&entities, &components, &renderer, &camera, &streamer, &scriptSystem, &inputSystem);
 
+    // Play-mode systems; the graph orders the ones whose access overlaps
+    // and would run the rest side by side. With the access declared below
+    // every system shares TransformComponent or Camera with the one before,
+    // so for now they form a chain and run one after another (Scripts does
+    // not overlap Physics).
+    SystemGraph playSystems;
+    playSystems.Add("PlayerController", [&](float dt, FrameArena&) {
+        PlayerControllerSystem::Update(entities, components, inputSystem, camera, dt);
+    }).Reads<InputSystem, Camera>().Writes<PlayerControllerComponent, TransformComponent, PhysicsComponent, Camera>();
+
+    playSystems.Add("Physics", [&](float dt, FrameArena&) {
+        PhysicsSystem::Update(entities, components, dt);
+    }).Reads<ColliderComponent>().Writes<PhysicsComponent, TransformComponent>();
+
+    playSystems.Add("CameraController", [&](float dt, FrameArena&) {
+        CameraControllerSystem::Update(entities, components, camera, dt);
+    }).Reads<CameraFollowComponent, TransformComponent, PlayerControllerComponent>().Writes<Camera>();
+
+    playSystems.Add("Scripts", [&](float dt, FrameArena&) {
+        for (auto [e, sc] : components.View<ScriptComponent>())
+            scriptSystem.Update(e, sc, dt);
+    }).Reads<InputSystem>().Writes<ScriptComponent, TransformComponent, PhysicsComponent>();
+
+    // Added after everything that moves entities, so it sees this frame's
+    // writes; only transforms marked since its last run are rebuilt
+    uint32_t transformTick = 0;
+    playSystems.Add("Transforms", [&](float, FrameArena& arena) {
+        transformTick = TransformSystem::Update(components, jobSystem, arena, transformTick);
+    }).Writes<TransformComponent>();
+
+    playSystems.Build();
+
     int windowW = 1920;
     int windowH = 1080;
 
     // ---------------- Main Loop ----------------
     while (running) {
+        if (spikeMs > 0.0f && frameMs > spikeMs && !traceWritten)
+            writeTrace("frame spike");
+
+        auto frameStart = std::chrono::high_resolution_clock::now();
+        PROFILE_ZONE("Frame");
+        frameArena.BeginFrame();
+        uint64_t heapAtFrameStart = HeapAllocationCount();
 
         /*ImGuiIO& io = ImGui::GetIO();
 
@@ -244,53 +332,56 @@ int main() {
 
       
 
-        while (SDL_PollEvent(&event)) {
-            ImGui_ImplSDL2_ProcessEvent(&event);
-            if (event.type == SDL_QUIT)
-                running = false;
-
-            if (event.type == SDL_WINDOWEVENT &&
-                (event.window.event == SDL_WINDOWEVENT_RESIZED ||
-                    event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED))
-            {
-                //  Handle window resizing dynamically
-                SDL_GetWindowSize(window, &windowW, &windowH);
-                camera.SetAspect((float)windowW, (float)windowH);
-            }
+        {
+            PROFILE_ZONE("Input");
+            while (SDL_PollEvent(&event)) {
+                ImGui_ImplSDL2_ProcessEvent(&event);
+                if (event.type == SDL_QUIT)
+                    running = false;
+
+                if (event.type == SDL_WINDOWEVENT &&
+                    (event.window.event == SDL_WINDOWEVENT_RESIZED ||
+                        event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED))
+                {
+                    //  Handle window resizing dynamically
+                    SDL_GetWindowSize(window, &windowW, &windowH);
+                    camera.SetAspect((float)windowW, (float)windowH);
+                }
 
-            if (event.type == SDL_KEYDOWN && !event.key.repeat)
-            {
-                inputSystem.OnKeyDown(event.key.keysym.scancode);
-            }
-            else if (event.type == SDL_KEYUP)
-            {
-                inputSystem.OnKeyUp(event.key.keysym.scancode);
-            }
+                if (event.type == SDL_KEYDOWN && !event.key.repeat)
+                {
+                    inputSystem.OnKeyDown(event.key.keysym.scancode);
+                }
+                else if (event.type == SDL_KEYUP)
+                {
+                    inputSystem.OnKeyUp(event.key.keysym.scancode);
+                }
 
-            if (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_RIGHT) {
-                rightMouseHeld = true;
-                SDL_SetRelativeMouseMode(SDL_TRUE);
-            }
-            if (event.type == SDL_MOUSEBUTTONUP && event.button.button == SDL_BUTTON_RIGHT) {
-                rightMouseHeld = false;
-                SDL_SetRelativeMouseMode(SDL_FALSE);
-            }
-            if (event.type == SDL_MOUSEMOTION && rightMouseHeld)
-            {
-                inputSystem.OnMouseMove(
-                    (float)event.motion.xrel,
-                    (float)event.motion.yrel
-                );
-            }
+                if (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_RIGHT) {
+                    rightMouseHeld = true;
+                    SDL_SetRelativeMouseMode(SDL_TRUE);
+                }
+                if (event.type == SDL_MOUSEBUTTONUP && event.button.button == SDL_BUTTON_RIGHT) {
+                    rightMouseHeld = false;
+                    SDL_SetRelativeMouseMode(SDL_FALSE);
+                }
+                if (event.type == SDL_MOUSEMOTION && rightMouseHeld)
+                {
+                    inputSystem.OnMouseMove(
+                        (float)event.motion.xrel,
+                        (float)event.motion.yrel
+                    );
+                }
 
-            if (inputSystem.Pressed("Jump"))
-            {
-                EditorConsole::Log("[Input] Jump pressed");
-            }
+                if (inputSystem.Pressed("Jump"))
+                {
+                    EditorConsole::Log("[Input] Jump pressed");
+                }
 
-            if (inputSystem.Held("MoveForward"))
-            {
-                EditorConsole::Log("[Input] Holding MoveForward");
+                if (inputSystem.Held("MoveForward"))
+                {
+                    EditorConsole::Log("[Input] Holding MoveForward");
+                }
             }
         }
 
@@ -301,41 +392,20 @@ int main() {
         last = now;
 
 
+        // New change-tracking tick for this frame's writes
+        components.AdvanceTick();
+
         if (editor.GetEngineMode() == EngineMode::Play)
         {
-            PlayerControllerSystem::Update(
-                entities,
-                components,
-                inputSystem,
-                camera,
-                dt
-            );
-
-            PhysicsSystem::Update(
-                entities,
-                components,
-                dt
-            );
-
-            CameraControllerSystem::Update(
-                entities,
-                components,
-                camera,
-                dt
-            );
-
-            for (EntityID id = 0; id < entities.GetMaxEntities(); ++id)
             {
-                Entity e{ id }; // construct Entity properly
-
-                if (!entities.IsAlive(e))
-                    continue;
-
-                if (!components.HasComponent<ScriptComponent>(e))
-                    continue;
+                PROFILE_ZONE("Play systems");
+                playSystems.Run(jobSystem, frameArena, dt);
+            }
 
-                auto& sc = components.GetComponent<ScriptComponent>(e);
-                scriptSystem.Update(e, sc, dt);
+            // Sync point: apply what scripts queued while iterating
+            {
+                PROFILE_ZONE("Playback");
+                scriptSystem.GetCommandBuffer().Playback(entities, components);
             }
         }
 
@@ -362,6 +432,7 @@ int main() {
 
         if (appState == AppState::Startup)
         {
+            PROFILE_ZONE("Startup screen");
             auto result = startupScreen.Draw();
 
             if (result.projectChosen && !result.projectPath.empty())
@@ -401,6 +472,7 @@ int main() {
         }
         else if (appState == AppState::Editor)
         {
+            PROFILE_ZONE("Editor");
             editor.Draw();
         }
 
@@ -409,24 +481,44 @@ int main() {
        
 
         // ---------------- Render ImGui ----------------
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-
-    
-        if (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
         {
-            SDL_Window* backup_current_window = SDL_GL_GetCurrentWindow();
-            SDL_GLContext backup_current_context = SDL_GL_GetCurrentContext();
+            PROFILE_ZONE("Render ImGui");
+            ImGui::Render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+            if (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
+            {
+                SDL_Window* backup_current_window = SDL_GL_GetCurrentWindow();
+                SDL_GLContext backup_current_context = SDL_GL_GetCurrentContext();
+
+                ImGui::UpdatePlatformWindows();
+                ImGui::RenderPlatformWindowsDefault();
 
-            ImGui::UpdatePlatformWindows();
-            ImGui::RenderPlatformWindowsDefault();
+                SDL_GL_MakeCurrent(backup_current_window, backup_current_context);
+            }
+        }
 
-            SDL_GL_MakeCurrent(backup_current_window, backup_current_context);
+        {
+            PROFILE_ZONE("Swap");
+            SDL_GL_SwapWindow(window);
         }
 
-        SDL_GL_SwapWindow(window);
+        // ---------------- Frame end: job and memory stats ----------------
+        jobSystem.CollectStats(jobStats);
+        jobTrace.clear();
+        jobSystem.CollectTrace(jobTrace);
+        profiler.recordJobs(jobStats, jobTrace);
+        profiler.recordFrameMemory(HeapAllocationCount() - heapAtFrameStart, frameArena.GetStats());
+        profiler.recordLuaMemory(scriptSystem.GetMemory());
+        if (showProfiler)
+            profiler.update(dt * 1000.0f);
+
+        frameMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - frameStart).count();
     }
 
+    if (Profiler::IsEnabled() && !traceWritten)
+        writeTrace("exit");
+
     // ---------------- Shutdown ----------------
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL2_Shutdown();
@@ -1,46 +1,139 @@
 #pragma once
 #include <string>
 #include <queue>
+#include <vector>
 #include <mutex>
-#include <future>
 #include <iostream>
+#include <thread>
+#include <chrono>
+#include <utility>
+#include <cstdint>
 #include "../Engine/JobSystem.h"
+#include "../Engine/Task.h"
+
+// Decoded asset, ready to be handed to the renderer on the main thread
+struct LoadedAsset {
+    std::string name;
+    std::vector<uint8_t> data;
+};
 
 // ------------------------------------------------------------
 // AsyncLoader - Simulates async file loading via JobSystem
+//
+// Each load is one Task: read on the I/O lane (it blocks, so a flood
+// of requests queues up there instead of occupying the workers that
+// per-frame jobs need), decode on the workers, then wait to be picked
+// up. Update polls the tasks on the main thread without blocking.
 // ------------------------------------------------------------
 class AsyncLoader {
 public:
     explicit AsyncLoader(JobSystem& js) : m_JobSystem(js) {}
 
-    void RequestLoad(const std::string& assetName) {
+    // Running loads refer back to the loader, so let them finish first
+    ~AsyncLoader() {
+        while (GetPendingLoads() > 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    static constexpr size_t DefaultSimulatedBytes = 64 * 1024;
+
+    // simulatedBytes: size the simulated read returns
+    void RequestLoad(const std::string& assetName, size_t simulatedBytes = DefaultSimulatedBytes) {
         std::lock_guard<std::mutex> lock(m_Mutex);
-        m_LoadQueue.push(assetName);
+        m_LoadQueue.push({ assetName, simulatedBytes });
     }
 
+    // Main thread, once per frame: starts requested loads and collects
+    // the finished ones for TakeCompleted
     void Update() {
-        std::queue<std::string> pending;
+        std::queue<Request> pending;
         {
             std::lock_guard<std::mutex> lock(m_Mutex);
             std::swap(pending, m_LoadQueue);
         }
 
         while (!pending.empty()) {
-            std::string asset = pending.front();
+            m_Loads.push_back({ pending.front().name, Load(pending.front().name, pending.front().bytes) });
+            m_Loads.back().task.Start(m_JobSystem, JobPriority::Background);
             pending.pop();
+        }
+
+        for (size_t i = 0; i < m_Loads.size(); ) {
+            InFlight& load = m_Loads[i];
+            if (!load.task.IsReady()) {
+                ++i;
+                continue;
+            }
+
+            try {
+                m_Completed.push_back(std::move(load.task.Result()));
+                std::cout << "[AsyncLoader] Loaded asset: " << load.name << "\n";
+            }
+            catch (const std::exception& e) {
+                std::cerr << "[AsyncLoader] Failed to load " << load.name << ": " << e.what() << "\n";
+            }
 
-            Job* job = m_JobSystem.CreateJob([asset]() {
-                // Simulate file I/O latency
-                std::this_thread::sleep_for(std::chrono::milliseconds(100 + rand() % 200));
-                std::cout << "[AsyncLoader] Loaded asset: " << asset
-                    << " on thread " << std::this_thread::get_id() << "\n";
-                });
-            m_JobSystem.Run(job);
+            if (&load != &m_Loads.back())
+                load = std::move(m_Loads.back());
+            m_Loads.pop_back();
         }
     }
 
+    // Assets finished since the last call, ready for upload
+    std::vector<LoadedAsset> TakeCompleted() {
+        return std::exchange(m_Completed, {});
+    }
+
+    // Loads started that have not finished yet
+    size_t GetPendingLoads() const {
+        size_t count = 0;
+        for (const InFlight& load : m_Loads)
+            count += load.task.IsReady() ? 0 : 1;
+        return count;
+    }
+
 private:
+    struct Request {
+        std::string name;
+        size_t bytes;
+    };
+
+    struct InFlight {
+        std::string name;
+        Task<LoadedAsset> task;
+    };
+
+    // read -> decode -> upload-ready
+    Task<LoadedAsset> Load(std::string asset, size_t bytes) {
+        auto read = [asset, bytes]() {
+            // Simulate file I/O latency
+            std::this_thread::sleep_for(std::chrono::milliseconds(100 + rand() % 200));
+            return std::vector<uint8_t>(bytes, static_cast<uint8_t>(asset.size()));
+        };
+        std::vector<uint8_t> raw = co_await RunIO(m_JobSystem, read, JobPriority::Background);
+
+        // Simulated decode, in slices on the workers
+        LoadedAsset loaded{ asset, std::vector<uint8_t>(raw.size()) };
+        constexpr size_t Slices = 4;
+        const size_t sliceSize = raw.size() / Slices;
+
+        Job* decode = m_JobSystem.CreateJob([]() {});
+        for (size_t s = 0; s < Slices; ++s) {
+            // The last slice also takes the size % Slices bytes left over
+            size_t end = s + 1 == Slices ? raw.size() : (s + 1) * sliceSize;
+            m_JobSystem.Run(m_JobSystem.CreateJob([&raw, &loaded, s, sliceSize, end]() {
+                for (size_t i = s * sliceSize; i < end; ++i)
+                    loaded.data[i] = raw[i] ^ 0x5A;
+                }, decode), JobPriority::Background);
+        }
+        co_await RunJob(m_JobSystem, decode, JobPriority::Background);
+
+        co_return loaded;
+    }
+
     JobSystem& m_JobSystem;
     std::mutex m_Mutex;
-    std::queue<std::string> m_LoadQueue;
+    std::queue<Request> m_LoadQueue;
+    std::vector<InFlight> m_Loads;          // main thread only
+    std::vector<LoadedAsset> m_Completed;
 };
@@ -1,18 +1,88 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <new>
+#include <memory>
+#include <utility>
+
 
 struct AllocatorStats {
     size_t totalAllocated = 0;   // current allocated bytes
-    size_t peakUsage = 0;        // maximum allocated at once
+    size_t peakUsage = 0;        // maximum allocated + padding at once
     size_t allocationCount = 0;  // number of allocations ever made
+    size_t paddingBytes = 0;     // current bytes skipped to satisfy alignment
 };
 
 
 class Allocator {
 public:
+    // What allocate(size) guarantees, same as malloc
+    static constexpr size_t DefaultAlignment = alignof(std::max_align_t);
+
     virtual ~Allocator() = default;
-    virtual void* allocate(size_t size) = 0;
+
+    // alignment must be a power of two; nullptr if the request can't be met
+    virtual void* allocate(size_t size, size_t alignment) = 0;
+    void* allocate(size_t size) { return allocate(size, DefaultAlignment); }
+
     virtual void deallocate(void* ptr) = 0;
     virtual void reset() = 0;
 	virtual AllocatorStats getStats() const = 0;
-};
\ No newline at end of file
+
+    // Typed helpers: construct in place with the type's own alignment.
+    // nullptr when the allocator is out of room.
+    template<typename T, typename... Args>
+    T* New(Args&&... args) {
+        void* memory = allocate(sizeof(T), alignof(T));
+        if (!memory) return nullptr;
+        try {
+            return new (memory) T(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            deallocate(memory);
+            throw;
+        }
+    }
+
+    // Default-initialised, like new T[count]
+    template<typename T>
+    T* NewArray(size_t count) {
+        if (count > SIZE_MAX / sizeof(T)) return nullptr;
+        void* memory = allocate(sizeof(T) * count, alignof(T));
+        if (!memory) return nullptr;
+        T* first = static_cast<T*>(memory);
+        try {
+            std::uninitialized_default_construct_n(first, count);
+        }
+        catch (...) {
+            deallocate(memory);
+            throw;
+        }
+        return first;
+    }
+
+    template<typename T>
+    void Delete(T* object) {
+        if (!object) return;
+        object->~T();
+        deallocate(object);
+    }
+
+    template<typename T>
+    void DeleteArray(T* first, size_t count) {
+        if (!first) return;
+        std::destroy_n(first, count);
+        deallocate(first);
+    }
+
+protected:
+    static bool isValidAlignment(size_t alignment) {
+        return alignment != 0 && (alignment & (alignment - 1)) == 0;
+    }
+
+    static uintptr_t alignAddress(uintptr_t address, size_t alignment) {
+        return (address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    }
+};
@@ -0,0 +1,171 @@
+#include "pch.h"
+#include "ConcurrentPoolAllocator.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+ConcurrentPoolAllocator::ConcurrentPoolAllocator(size_t blockSize, size_t numBlocks, size_t blockAlignment)
+    : m_BlockSize(blockSize), m_NumBlocks(numBlocks),
+    m_BlockAlignment(blockAlignment < alignof(void*) ? alignof(void*) : blockAlignment),
+    m_Head(pack(Null, 0))
+{
+    if (!isValidAlignment(blockAlignment) || numBlocks == 0 || numBlocks >= Null)
+        throw std::invalid_argument("ConcurrentPoolAllocator needs a power-of-two alignment and 1..2^32-2 blocks");
+
+    m_Stride = static_cast<size_t>(alignAddress(blockSize ? blockSize : 1, m_BlockAlignment));
+    m_Memory = static_cast<char*>(::operator new(m_Stride * numBlocks, std::align_val_t{ m_BlockAlignment }));
+    m_Next.reset(new std::atomic<uint32_t>[numBlocks]);
+
+    reset();
+}
+
+ConcurrentPoolAllocator::~ConcurrentPoolAllocator()
+{
+    ::operator delete(m_Memory, std::align_val_t{ m_BlockAlignment });
+}
+
+void* ConcurrentPoolAllocator::allocate(size_t size, size_t alignment)
+{
+    assert(isValidAlignment(alignment) && "Alignment must be a power of two!");
+    if (size > m_BlockSize || alignment > m_BlockAlignment) return nullptr;
+
+    ThreadCache& cache = localCache();
+    uint32_t count = cache.count.load(std::memory_order_relaxed);
+    if (count == 0 && (count = refill(cache)) == 0)
+        return nullptr;
+
+    uint32_t index = cache.blocks[--count];
+    cache.count.store(count, std::memory_order_relaxed);
+    cache.allocations.store(cache.allocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return m_Memory + size_t(index) * m_Stride;
+}
+
+void ConcurrentPoolAllocator::deallocate(void* ptr)
+{
+    if (!ptr) return;
+    size_t offset = static_cast<size_t>(static_cast<char*>(ptr) - m_Memory);
+    assert(offset < m_NumBlocks * m_Stride && offset % m_Stride == 0 && "Pointer not from this pool!");
+
+    ThreadCache& cache = localCache();
+    uint32_t count = cache.count.load(std::memory_order_relaxed);
+    if (count == CacheCapacity)
+    {
+        // Give back the coldest half; the recently freed blocks stay here
+        giveBack(cache, 0, Batch);
+        std::memmove(cache.blocks, cache.blocks + Batch, (CacheCapacity - Batch) * sizeof(uint32_t));
+        count -= Batch;
+    }
+
+    cache.blocks[count++] = static_cast<uint32_t>(offset / m_Stride);
+    cache.count.store(count, std::memory_order_relaxed);
+}
+
+uint32_t ConcurrentPoolAllocator::refill(ThreadCache& cache)
+{
+    uint64_t head = m_Head.load(std::memory_order_acquire);
+    for (;;)
+    {
+        uint32_t first = indexOf(head);
+        if (first == Null)
+            return 0;
+
+        // Walk up to a batch down the list. If another thread changes
+        // the list meanwhile, the links read here may be stale, but the
+        // tag makes the exchange below fail and we start over.
+        uint32_t taken = 1;
+        uint32_t last = first;
+        while (taken < Batch)
+        {
+            uint32_t next = m_Next[last].load(std::memory_order_relaxed);
+            if (next == Null)
+                break;
+            last = next;
+            ++taken;
+        }
+        uint32_t rest = m_Next[last].load(std::memory_order_relaxed);
+
+        if (m_Head.compare_exchange_weak(head, pack(rest, tagOf(head) + 1),
+                std::memory_order_acquire, std::memory_order_acquire))
+        {
+            // The chain is ours now
+            uint32_t index = first;
+            for (uint32_t i = 0; i < taken; ++i) {
+                cache.blocks[i] = index;
+                index = m_Next[index].load(std::memory_order_relaxed);
+            }
+            cache.count.store(taken, std::memory_order_relaxed);
+
+            size_t outside = m_NumBlocks - (m_SharedFree.fetch_sub(taken, std::memory_order_relaxed) - taken);
+            size_t peak = m_PeakTaken.load(std::memory_order_relaxed);
+            while (outside > peak && !m_PeakTaken.compare_exchange_weak(peak, outside, std::memory_order_relaxed))
+            {
+            }
+            return taken;
+        }
+    }
+}
+
+void ConcurrentPoolAllocator::giveBack(ThreadCache& cache, uint32_t first, uint32_t count)
+{
+    if (count == 0)
+        return;
+
+    // Link the run privately, then push it with one exchange
+    for (uint32_t i = first; i + 1 < first + count; ++i)
+        m_Next[cache.blocks[i]].store(cache.blocks[i + 1], std::memory_order_relaxed);
+
+    // Count them first, so the count never drops below what is listed
+    m_SharedFree.fetch_add(count, std::memory_order_relaxed);
+
+    uint32_t top = cache.blocks[first];
+    uint32_t bottom = cache.blocks[first + count - 1];
+    uint64_t head = m_Head.load(std::memory_order_relaxed);
+    do {
+        m_Next[bottom].store(indexOf(head), std::memory_order_relaxed);
+    } while (!m_Head.compare_exchange_weak(head, pack(top, tagOf(head) + 1),
+                std::memory_order_release, std::memory_order_relaxed));
+}
+
+void ConcurrentPoolAllocator::flushThreadCache()
+{
+    ThreadCache& cache = localCache();
+    giveBack(cache, 0, cache.count.load(std::memory_order_relaxed));
+    cache.count.store(0, std::memory_order_relaxed);
+}
+
+void ConcurrentPoolAllocator::reset()
+{
+    for (size_t i = 0; i < m_NumBlocks; ++i)
+        m_Next[i].store(i + 1 < m_NumBlocks ? static_cast<uint32_t>(i + 1) : Null, std::memory_order_relaxed);
+
+    m_Head.store(pack(0, tagOf(m_Head.load(std::memory_order_relaxed)) + 1), std::memory_order_release);
+    m_SharedFree.store(m_NumBlocks, std::memory_order_relaxed);
+    m_PeakTaken.store(0, std::memory_order_relaxed);
+
+    m_Caches.ForEach([](ThreadCache& cache) {
+        cache.count.store(0, std::memory_order_relaxed);
+        cache.allocations.store(0, std::memory_order_relaxed);
+    });
+}
+
+AllocatorStats ConcurrentPoolAllocator::getStats() const
+{
+    size_t cached = 0;
+    AllocatorStats stats;
+    m_Caches.ForEach([&](const ThreadCache& cache) {
+        cached += cache.count.load(std::memory_order_relaxed);
+        stats.allocationCount += cache.allocations.load(std::memory_order_relaxed);
+    });
+
+    size_t outside = m_NumBlocks - m_SharedFree.load(std::memory_order_relaxed);
+    size_t inUse = outside > cached ? outside - cached : 0;
+    stats.totalAllocated = inUse * m_BlockSize;
+    stats.paddingBytes = inUse * (m_Stride - m_BlockSize);
+    stats.peakUsage = m_PeakTaken.load(std::memory_order_relaxed) * m_Stride;
+    return stats;
+}
+
+ConcurrentPoolAllocator::ThreadCache& ConcurrentPoolAllocator::localCache()
+{
+    return m_Caches.Local([]() { return std::make_unique<ThreadCache>(); });
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Allocator.h"
+#include "../../PerThread.h"
+#include <atomic>
+#include <memory>
+
+// ------------------------------------------------------------
+// ConcurrentPoolAllocator - fixed-size blocks, shared by any threads
+//
+// Like PoolAllocator, but allocate/deallocate may be called from any
+// thread at once, and a block may be freed on a different thread than
+// the one that allocated it.
+//
+// Each thread works out of its own cache of free block indices and
+// touches shared state only once per Batch operations: an empty cache
+// takes a batch off the shared free list, a full one gives a batch
+// back. The shared list is a lock-free stack. Its head packs the top
+// block index with a counter that changes on every update, so a
+// compare-exchange never succeeds against a head that was popped and
+// pushed back in between (ABA). The links live in a side table rather
+// than in the blocks, so a stale reader never races with a block's
+// new owner.
+//
+// A thread's cache holds up to CacheCapacity blocks that other threads
+// can't reach; a thread that is done with the pool can hand them back
+// with flushThreadCache. reset() must not run concurrently with
+// anything else.
+// ------------------------------------------------------------
+class ConcurrentPoolAllocator : public Allocator {
+public:
+    static constexpr uint32_t CacheCapacity = 64;
+    static constexpr uint32_t Batch = CacheCapacity / 2;
+
+    ConcurrentPoolAllocator(size_t blockSize, size_t numBlocks, size_t blockAlignment = DefaultAlignment);
+    ~ConcurrentPoolAllocator() override;
+
+    ConcurrentPoolAllocator(const ConcurrentPoolAllocator&) = delete;
+    ConcurrentPoolAllocator& operator=(const ConcurrentPoolAllocator&) = delete;
+
+    using Allocator::allocate;
+
+    void* allocate(size_t size, size_t alignment) override;
+    void deallocate(void* ptr) override;
+    void reset() override;
+
+    // Exact once other threads are idle; a snapshot while they run.
+    // peakUsage counts blocks taken off the shared list, so it includes
+    // blocks waiting in thread caches.
+    AllocatorStats getStats() const override;
+
+    // Returns the calling thread's cached blocks to the shared list
+    void flushThreadCache();
+
+private:
+    static constexpr uint32_t Null = UINT32_MAX;
+
+    // Owner-written; the atomics are for getStats
+    struct ThreadCache {
+        uint32_t blocks[CacheCapacity];
+        std::atomic<uint32_t> count{ 0 };
+        std::atomic<uint64_t> allocations{ 0 };
+    };
+
+    static uint64_t pack(uint32_t index, uint32_t tag) { return (uint64_t(tag) << 32) | index; }
+    static uint32_t indexOf(uint64_t head) { return static_cast<uint32_t>(head); }
+    static uint32_t tagOf(uint64_t head) { return static_cast<uint32_t>(head >> 32); }
+
+    ThreadCache& localCache();
+    uint32_t refill(ThreadCache& cache);
+    void giveBack(ThreadCache& cache, uint32_t first, uint32_t count);
+
+    size_t m_BlockSize;
+    size_t m_NumBlocks;
+    size_t m_BlockAlignment;
+    size_t m_Stride;                            // block size rounded up to the alignment
+    char* m_Memory;
+    std::unique_ptr<std::atomic<uint32_t>[]> m_Next;   // free list links, by block index
+
+    alignas(64) std::atomic<uint64_t> m_Head;   // tag:32 | top index:32
+    alignas(64) std::atomic<size_t> m_SharedFree{ 0 };
+    std::atomic<size_t> m_PeakTaken{ 0 };
+
+    PerThread<ThreadCache> m_Caches;
+};
@@ -0,0 +1,65 @@
+#include "pch.h"
+#include "FrameArena.h"
+#include <algorithm>
+
+FrameArena::FrameArena(size_t blockBytes)
+    : m_BlockBytes(blockBytes)
+{
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+    ThreadArena& arena = Local();
+    uint64_t frame = GetFrame();
+    Buffer& buffer = arena.buffers[frame & 1];
+
+    // First allocation on this thread this frame: what the set held
+    // two frames ago is free again
+    if (buffer.frame.load(std::memory_order_relaxed) != frame)
+    {
+        for (auto& block : buffer.blocks)
+            block->reset();
+        buffer.current = 0;
+        buffer.used.store(0, std::memory_order_relaxed);
+        buffer.frame.store(frame, std::memory_order_relaxed);
+    }
+
+    for (;;)
+    {
+        // A fresh block has room for this even at the worst-case padding
+        if (buffer.current == buffer.blocks.size())
+        {
+            size_t bytes = std::max(m_BlockBytes, size + alignment - 1);
+            buffer.blocks.push_back(std::make_unique<LinearAllocator>(bytes));
+            arena.reserved.store(arena.reserved.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+        }
+
+        if (void* memory = buffer.blocks[buffer.current]->allocate(size, alignment))
+        {
+            buffer.used.store(buffer.used.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+            return memory;
+        }
+
+        ++buffer.current;   // block full (or too small), move on to the next one
+    }
+}
+
+FrameArena::Stats FrameArena::GetStats() const
+{
+    uint64_t frame = GetFrame();
+    Stats stats;
+
+    m_Threads.ForEach([&](const ThreadArena& arena) {
+        const Buffer& buffer = arena.buffers[frame & 1];
+        if (buffer.frame.load(std::memory_order_relaxed) == frame)
+            stats.usedBytes += buffer.used.load(std::memory_order_relaxed);
+        stats.reservedBytes += arena.reserved.load(std::memory_order_relaxed);
+        ++stats.threads;
+    });
+    return stats;
+}
+
+FrameArena::ThreadArena& FrameArena::Local()
+{
+    return m_Threads.Local([]() { return std::make_unique<ThreadArena>(); });
+}
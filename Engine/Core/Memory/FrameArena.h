@@ -0,0 +1,81 @@
+#pragma once
+
+#include "LinearAllocator.h"
+#include "../../PerThread.h"
+#include <atomic>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// ------------------------------------------------------------
+// FrameArena - per-thread, double-buffered scratch memory
+//
+// For temporary arrays that live for a frame: draw lists, culling
+// results, contact lists. Each thread that allocates gets two sets
+// of LinearAllocator blocks and uses set (frame & 1). The first
+// allocation a thread makes in a new frame resets that set, so memory
+// handed out in frame N stays valid until the end of frame N+1 (a job
+// started late in one frame can still finish in the next). Jobs that
+// run longer than that must not use the arena.
+//
+// A set that runs out chains another block, which it keeps, so once
+// a game has seen its busiest frame the arena stops touching the
+// heap. Nothing is destroyed on reset: only trivially destructible
+// types go in here.
+// ------------------------------------------------------------
+class FrameArena {
+public:
+    static constexpr size_t DefaultBlockBytes = 256 * 1024;
+
+    explicit FrameArena(size_t blockBytes = DefaultBlockBytes);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Main thread, at the top of each frame
+    void BeginFrame() { m_Frame.fetch_add(1, std::memory_order_release); }
+    uint64_t GetFrame() const { return m_Frame.load(std::memory_order_acquire); }
+
+    // From the calling thread's arena; never nullptr
+    void* Allocate(size_t size, size_t alignment = Allocator::DefaultAlignment);
+
+    // count default-initialised Ts (uninitialised for scalars)
+    template<typename T>
+    std::span<T> AllocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "Frame memory is reused without running destructors");
+        if (count > SIZE_MAX / sizeof(T)) throw std::bad_alloc();
+        T* first = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+        std::uninitialized_default_construct_n(first, count);
+        return { first, count };
+    }
+
+    struct Stats {
+        size_t usedBytes = 0;       // handed out this frame, all threads
+        size_t reservedBytes = 0;   // block capacity, both sets
+        size_t threads = 0;         // threads that have allocated
+    };
+    Stats GetStats() const;
+
+private:
+    struct Buffer {
+        std::vector<std::unique_ptr<LinearAllocator>> blocks;
+        size_t current = 0;
+        std::atomic<uint64_t> frame{ UINT64_MAX };   // frame the blocks were last reset for
+        std::atomic<size_t> used{ 0 };
+    };
+
+    // Written only by its owner; the atomics are for GetStats
+    struct ThreadArena {
+        Buffer buffers[2];
+        std::atomic<size_t> reserved{ 0 };
+    };
+
+    ThreadArena& Local();
+
+    size_t m_BlockBytes;
+    std::atomic<uint64_t> m_Frame{ 0 };
+
+    PerThread<ThreadArena> m_Threads;
+};
@@ -0,0 +1,104 @@
+#include "pch.h"
+#include "HeapCounter.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+// Allocations are counted per thread, so the hot path never fights over
+// one cache line; threads take shards round robin (two threads share one
+// only past ShardCount) and a read sums them all
+static constexpr size_t ShardCount = 64;
+
+struct alignas(64) CounterShard {
+    std::atomic<uint64_t> count{ 0 };
+};
+
+static CounterShard s_Shards[ShardCount];
+static std::atomic<uint32_t> s_NextShard{ 0 };
+static thread_local uint32_t t_Shard = UINT32_MAX;   // constant-initialised: safe inside operator new
+
+uint64_t HeapAllocationCount()
+{
+    uint64_t total = 0;
+    for (const CounterShard& shard : s_Shards)
+        total += shard.count.load(std::memory_order_relaxed);
+    return total;
+}
+
+#if ENGINE_HEAP_COUNTER
+
+static void CountAllocation()
+{
+    if (t_Shard == UINT32_MAX)
+        t_Shard = s_NextShard.fetch_add(1, std::memory_order_relaxed) % ShardCount;
+    s_Shards[t_Shard].count.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void* RawAllocate(size_t size)
+{
+    return std::malloc(size);
+}
+
+static void* RawAllocateAligned(size_t size, size_t alignment)
+{
+#if defined(_WIN32)
+    return _aligned_malloc(size, alignment);
+#else
+    void* p = nullptr;
+    return posix_memalign(&p, std::max(alignment, sizeof(void*)), size) == 0 ? p : nullptr;
+#endif
+}
+
+// What the standard asks of a replacement: on failure call the
+// new-handler and retry, throw bad_alloc only when there is none
+template<typename Allocate>
+static void* AllocateOrThrow(Allocate&& allocate)
+{
+    for (;;)
+    {
+        if (void* p = allocate()) {
+            CountAllocation();
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new(size_t size)
+{
+    if (size == 0)
+        size = 1;
+    return AllocateOrThrow([size]() { return RawAllocate(size); });
+}
+
+// Memory from here only ever comes back through the align_val_t deletes
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    if (size == 0)
+        size = 1;
+    return AllocateOrThrow([size, alignment]() { return RawAllocateAligned(size, static_cast<size_t>(alignment)); });
+}
+
+static void FreeAligned(void* p) noexcept
+{
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { FreeAligned(p); }
+
+#endif
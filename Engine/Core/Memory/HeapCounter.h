@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+// ------------------------------------------------------------
+// HeapCounter - counts every global operator new in the process
+//
+// HeapCounter.cpp replaces the global allocation functions, plain and
+// over-aligned, with ones that bump a counter and forward to the CRT;
+// the array and nothrow forms forward to those. Anything linking the
+// engine gets them. The profiler takes the difference across a frame,
+// tests across a block of code they expect to stay off the heap.
+//
+// Build with ENGINE_HEAP_COUNTER=0 to keep the CRT's own operators;
+// the count then stays 0.
+// ------------------------------------------------------------
+
+#ifndef ENGINE_HEAP_COUNTER
+#define ENGINE_HEAP_COUNTER 1
+#endif
+
+// Allocations made so far, on every thread
+uint64_t HeapAllocationCount();
@@ -22,20 +22,24 @@ public:
         std::free(m_Start);
     }
 
-    void* allocate(size_t size) override {
-        // Align to 4 bytes (optional)
+    using Allocator::allocate;
+
+    void* allocate(size_t size, size_t alignment) override {
+        assert(isValidAlignment(alignment) && "Alignment must be a power of two!");
         uintptr_t currentAddr = reinterpret_cast<uintptr_t>(m_Current);
-        uintptr_t alignedAddr = (currentAddr + 3) & ~static_cast<uintptr_t>(3);
-        char* alignedPtr = reinterpret_cast<char*>(alignedAddr);
+        size_t padding = alignAddress(currentAddr, alignment) - currentAddr;
 
-        if (alignedPtr + size > m_End) return nullptr;
+        size_t remaining = static_cast<size_t>(m_End - m_Current);
+        if (padding > remaining || size > remaining - padding) return nullptr;
 
+        char* alignedPtr = m_Current + padding;
         m_Current = alignedPtr + size;
 
         m_Stats.totalAllocated += size;
+        m_Stats.paddingBytes += padding;
         m_Stats.allocationCount++;
-        if (m_Stats.totalAllocated > m_Stats.peakUsage)
-            m_Stats.peakUsage = m_Stats.totalAllocated;
+        if (m_Stats.totalAllocated + m_Stats.paddingBytes > m_Stats.peakUsage)
+            m_Stats.peakUsage = m_Stats.totalAllocated + m_Stats.paddingBytes;
 
         return alignedPtr;
     }
@@ -47,6 +51,7 @@ public:
     void reset() override {
         m_Current = m_Start;
         m_Stats.totalAllocated = 0; // reset current usage
+        m_Stats.paddingBytes = 0;
     }
 
     AllocatorStats getStats() const override {
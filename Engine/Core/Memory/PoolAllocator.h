@@ -4,34 +4,49 @@
 #include <cstdlib>
 #include <cstddef>
 #include <stdexcept>
+#include <new>
 
 class PoolAllocator : public Allocator {
 public:
 	AllocatorStats m_Stats;
-     explicit PoolAllocator(size_t blockSize, size_t numBlocks)
-        : m_BlockSize(blockSize), m_NumBlocks(numBlocks)
+
+    // Every block starts on a blockAlignment boundary; blocks are laid
+    // out blockSize rounded up to that, and the round-up is padding
+     explicit PoolAllocator(size_t blockSize, size_t numBlocks, size_t blockAlignment = DefaultAlignment)
+        : m_BlockSize(blockSize), m_NumBlocks(numBlocks),
+        m_BlockAlignment(blockAlignment < alignof(void*) ? alignof(void*) : blockAlignment)
     {
-        m_MemoryBlock = std::malloc(blockSize * numBlocks);
-        if (!m_MemoryBlock) throw std::bad_alloc();
+        if (!isValidAlignment(blockAlignment) || numBlocks == 0)
+            throw std::invalid_argument("PoolAllocator needs a power-of-two alignment and at least one block");
+
+        // The free list link lives in the block itself
+        size_t stride = blockSize < sizeof(void*) ? sizeof(void*) : blockSize;
+        m_Stride = static_cast<size_t>(alignAddress(stride, m_BlockAlignment));
+
+        m_MemoryBlock = ::operator new(m_Stride * numBlocks, std::align_val_t{ m_BlockAlignment });
 
         reset();
     }
 
     ~PoolAllocator() override {
-        std::free(m_MemoryBlock);
+        ::operator delete(m_MemoryBlock, std::align_val_t{ m_BlockAlignment });
     }
 
-    void* allocate(size_t size) override {
-        if (size > m_BlockSize || !m_FreeList) return nullptr;
+    using Allocator::allocate;
+
+    void* allocate(size_t size, size_t alignment) override {
+        assert(isValidAlignment(alignment) && "Alignment must be a power of two!");
+        if (size > m_BlockSize || alignment > m_BlockAlignment || !m_FreeList) return nullptr;
 
         // Pop from free list
         void* ptr = m_FreeList;
         m_FreeList = static_cast<void**>(*m_FreeList);
 
         m_Stats.totalAllocated += m_BlockSize;
+        m_Stats.paddingBytes += m_Stride - m_BlockSize;
         m_Stats.allocationCount++;
-        if (m_Stats.totalAllocated > m_Stats.peakUsage)
-            m_Stats.peakUsage = m_Stats.totalAllocated;
+        if (m_Stats.totalAllocated + m_Stats.paddingBytes > m_Stats.peakUsage)
+            m_Stats.peakUsage = m_Stats.totalAllocated + m_Stats.paddingBytes;
 
         return ptr;
     }
@@ -41,10 +56,14 @@ public:
         *static_cast<void**>(ptr) = m_FreeList;
         m_FreeList = static_cast<void**>(ptr);
 
-        if (m_Stats.totalAllocated >= m_BlockSize)
+        if (m_Stats.totalAllocated >= m_BlockSize) {
             m_Stats.totalAllocated -= m_BlockSize;
-        else
+            m_Stats.paddingBytes -= m_Stride - m_BlockSize;
+        }
+        else {
             m_Stats.totalAllocated = 0;
+            m_Stats.paddingBytes = 0;
+        }
 
     }
 
@@ -52,8 +71,8 @@ public:
         // Rebuild free list
         char* p = static_cast<char*>(m_MemoryBlock);
         for (size_t i = 0; i < m_NumBlocks - 1; ++i) {
-            *reinterpret_cast<void**>(p) = p + m_BlockSize;
-            p += m_BlockSize;
+            *reinterpret_cast<void**>(p) = p + m_Stride;
+            p += m_Stride;
         }
         *reinterpret_cast<void**>(p) = nullptr; // last block
         m_FreeList = static_cast<void**>(m_MemoryBlock);
@@ -69,6 +88,8 @@ public:
 private:
     size_t m_BlockSize;
     size_t m_NumBlocks;
+    size_t m_BlockAlignment;
+    size_t m_Stride;      // block size rounded up to the alignment
     void* m_MemoryBlock;  // base pointer for free()
     void** m_FreeList;    // linked free list
 };
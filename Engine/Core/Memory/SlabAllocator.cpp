@@ -0,0 +1,242 @@
+#include "pch.h"
+#include "SlabAllocator.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Class index for each request size in 16-byte steps, so picking a
+// class is one lookup instead of a search
+static constexpr auto s_ClassBySixteenths = []() {
+    std::array<uint8_t, SlabAllocator::MaxClassSize / 16 + 1> table{};
+    size_t index = 0;
+    for (size_t i = 0; i < table.size(); ++i) {
+        while (SlabAllocator::ClassSizes[index] < i * 16) ++index;
+        table[i] = static_cast<uint8_t>(index);
+    }
+    return table;
+}();
+
+static size_t pageSize()
+{
+#if defined(_WIN32)
+    // VirtualAlloc hands out whole allocation-granularity units anyway
+    static const size_t size = []() { SYSTEM_INFO info; GetSystemInfo(&info); return size_t(info.dwAllocationGranularity); }();
+#else
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    return size;
+}
+
+SlabAllocator::SlabAllocator(size_t keepEmptySlabs)
+    : m_KeepEmptySlabs(keepEmptySlabs)
+{
+}
+
+SlabAllocator::~SlabAllocator()
+{
+    reset();
+}
+
+size_t SlabAllocator::classSizeFor(size_t size)
+{
+    return size <= MaxClassSize ? ClassSizes[s_ClassBySixteenths[(size + 15) / 16]] : 0;
+}
+
+void* SlabAllocator::allocate(size_t size, size_t alignment)
+{
+    assert(isValidAlignment(alignment) && "Alignment must be a power of two!");
+    if (alignment > SlabBytes / 2) return nullptr;
+    if (size > MaxClassSize) return allocateLarge(size, alignment);
+
+    size_t index = s_ClassBySixteenths[(size + 15) / 16];
+    while (index < ClassSizes.size() && classAlignment(ClassSizes[index]) < alignment)
+        ++index;
+    if (index == ClassSizes.size()) return allocateLarge(size, alignment);
+
+    size_t classSize = ClassSizes[index];
+    SizeClass& sizeClass = m_Classes[index];
+
+    Slab* slab = sizeClass.partial;
+    if (!slab)
+    {
+        size_t objectOffset = static_cast<size_t>(alignAddress(sizeof(Slab), classAlignment(classSize)));
+        slab = mapSlab(SlabBytes, objectOffset);
+        if (!slab) return nullptr;
+
+        slab->sizeClass = static_cast<uint32_t>(index);
+        slab->objectSize = classSize;
+        slab->capacity = static_cast<uint32_t>((SlabBytes - objectOffset) / classSize);
+        link(sizeClass.partial, slab);
+        ++sizeClass.emptySlabs;
+    }
+
+    if (slab->used == 0)
+        --sizeClass.emptySlabs;
+
+    // Reuse a freed object, else carve the next untouched one, so a
+    // fresh slab's pages are only touched as they are needed
+    void* ptr;
+    if (slab->freeList) {
+        ptr = slab->freeList;
+        slab->freeList = *static_cast<void**>(ptr);
+    }
+    else {
+        ptr = slab->first + size_t(slab->carved++) * classSize;
+    }
+
+    if (++slab->used == slab->capacity) {
+        unlink(sizeClass.partial, slab);
+        link(sizeClass.full, slab);
+    }
+
+    m_Stats.totalAllocated += classSize;
+    m_Stats.allocationCount++;
+    if (m_Stats.totalAllocated > m_Stats.peakUsage)
+        m_Stats.peakUsage = m_Stats.totalAllocated;
+
+    return ptr;
+}
+
+void* SlabAllocator::allocateLarge(size_t size, size_t alignment)
+{
+    size_t objectOffset = static_cast<size_t>(alignAddress(sizeof(Slab), alignment));
+    if (size > SIZE_MAX - objectOffset - pageSize()) return nullptr;
+
+    Slab* slab = mapSlab(static_cast<size_t>(alignAddress(objectOffset + size, pageSize())), objectOffset);
+    if (!slab) return nullptr;
+
+    slab->sizeClass = LargeClass;
+    slab->objectSize = size;
+    slab->capacity = slab->carved = slab->used = 1;
+    link(m_Large, slab);
+
+    m_Stats.totalAllocated += size;
+    m_Stats.allocationCount++;
+    if (m_Stats.totalAllocated > m_Stats.peakUsage)
+        m_Stats.peakUsage = m_Stats.totalAllocated;
+
+    return slab->first;
+}
+
+void SlabAllocator::deallocate(void* ptr)
+{
+    if (!ptr) return;
+
+    Slab* slab = reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(ptr) & ~uintptr_t(SlabBytes - 1));
+    m_Stats.totalAllocated -= slab->objectSize;
+
+    if (slab->sizeClass == LargeClass)
+    {
+        unlink(m_Large, slab);
+        unmapSlab(slab);
+        return;
+    }
+
+    assert(slab->sizeClass < ClassSizes.size() && "Pointer not from this allocator!");
+    SizeClass& sizeClass = m_Classes[slab->sizeClass];
+
+    *static_cast<void**>(ptr) = slab->freeList;
+    slab->freeList = ptr;
+
+    if (slab->used-- == slab->capacity) {
+        unlink(sizeClass.full, slab);
+        link(sizeClass.partial, slab);
+    }
+
+    if (slab->used == 0)
+    {
+        if (sizeClass.emptySlabs < m_KeepEmptySlabs) {
+            ++sizeClass.emptySlabs;
+        }
+        else {
+            unlink(sizeClass.partial, slab);
+            unmapSlab(slab);
+        }
+    }
+}
+
+void SlabAllocator::reset()
+{
+    for (SizeClass& sizeClass : m_Classes)
+    {
+        for (Slab* list : { sizeClass.partial, sizeClass.full })
+        {
+            while (list) {
+                Slab* next = list->next;
+                unmapSlab(list);
+                list = next;
+            }
+        }
+        sizeClass = {};
+    }
+
+    while (m_Large) {
+        Slab* next = m_Large->next;
+        unmapSlab(m_Large);
+        m_Large = next;
+    }
+
+    m_Stats = {};
+}
+
+SlabAllocator::Slab* SlabAllocator::mapSlab(size_t bytes, size_t objectOffset)
+{
+#if defined(_WIN32)
+    // Mappings start on a 64 KB allocation-granularity boundary
+    static_assert(SlabBytes == 64 * 1024, "Slabs rely on VirtualAlloc's 64 KB alignment");
+    char* base = static_cast<char*>(VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+    if (!base) return nullptr;
+    assert(reinterpret_cast<uintptr_t>(base) % SlabBytes == 0);
+#else
+    // Map a slab's worth extra, then trim to a SlabBytes boundary
+    size_t span = bytes + SlabBytes;
+    void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return nullptr;
+
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = alignAddress(start, SlabBytes);
+    if (aligned > start)
+        munmap(raw, aligned - start);
+    if (start + span > aligned + bytes)
+        munmap(reinterpret_cast<void*>(aligned + bytes), start + span - (aligned + bytes));
+    char* base = reinterpret_cast<char*>(aligned);
+#endif
+
+    m_MappedBytes += bytes;
+
+    Slab* slab = reinterpret_cast<Slab*>(base);
+    *slab = {};
+    slab->mappedBytes = bytes;
+    slab->first = base + objectOffset;
+    return slab;
+}
+
+void SlabAllocator::unmapSlab(Slab* slab)
+{
+    m_MappedBytes -= slab->mappedBytes;
+#if defined(_WIN32)
+    VirtualFree(slab, 0, MEM_RELEASE);
+#else
+    munmap(slab, slab->mappedBytes);
+#endif
+}
+
+void SlabAllocator::link(Slab*& list, Slab* slab)
+{
+    slab->prev = nullptr;
+    slab->next = list;
+    if (list) list->prev = slab;
+    list = slab;
+}
+
+void SlabAllocator::unlink(Slab*& list, Slab* slab)
+{
+    if (slab->prev) slab->prev->next = slab->next;
+    else list = slab->next;
+    if (slab->next) slab->next->prev = slab->prev;
+    slab->prev = slab->next = nullptr;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Allocator.h"
+#include <array>
+
+// ------------------------------------------------------------
+// SlabAllocator - general small-object allocator with size classes
+//
+// Requests up to 4096 bytes are rounded up to one of 16 size classes
+// and served from slabs: SlabBytes of pages mapped straight from the
+// OS, each holding objects of one class. A class that runs out maps
+// another slab, so unlike PoolAllocator this never fills up. When a
+// slab's last object is freed its pages go back to the OS, except for
+// keepEmptySlabs per class that stay mapped so a class that keeps
+// emptying and refilling doesn't pay for a map/unmap every time.
+//
+// Slabs are SlabBytes-aligned and start with their header, so
+// deallocate finds the slab by masking the pointer. Bigger requests
+// get a mapping of their own laid out the same way.
+//
+// Objects in a class are aligned to the largest power of two that
+// divides the class size (16 for 48, 4096 for 4096); a request with
+// a stronger alignment moves up to the first class that has it.
+// Alignments above SlabBytes / 2 are refused.
+//
+// Not thread-safe, like the other single-owner allocators.
+// ------------------------------------------------------------
+class SlabAllocator : public Allocator {
+public:
+    static constexpr size_t SlabBytes = 64 * 1024;
+    static constexpr size_t MaxClassSize = 4096;
+    static constexpr std::array<size_t, 16> ClassSizes = {
+        16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096
+    };
+
+    explicit SlabAllocator(size_t keepEmptySlabs = 1);
+    ~SlabAllocator() override;
+
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+    using Allocator::allocate;
+
+    void* allocate(size_t size, size_t alignment) override;
+    void deallocate(void* ptr) override;
+
+    // Frees everything and returns every slab to the OS
+    void reset() override;
+
+    // totalAllocated counts whole class sizes, so it includes the
+    // round-up; getMappedBytes is what the OS has given us
+    AllocatorStats getStats() const override { return m_Stats; }
+    size_t getMappedBytes() const { return m_MappedBytes; }
+
+    // Bytes actually reserved for a request of this size, or 0 if it
+    // is past the largest class
+    static size_t classSizeFor(size_t size);
+
+private:
+    static constexpr uint32_t LargeClass = UINT32_MAX;
+
+    struct Slab {
+        Slab* prev;
+        Slab* next;
+        void* freeList;        // objects freed back into this slab
+        size_t mappedBytes;
+        size_t objectSize;     // class size, or the request for a large one
+        uint32_t sizeClass;
+        uint32_t capacity;     // objects that fit
+        uint32_t carved;       // objects handed out at least once
+        uint32_t used;
+        char* first;           // first object
+    };
+
+    // Slabs with room go on partial, the rest on full; the partial
+    // list includes the empty slabs being kept
+    struct SizeClass {
+        Slab* partial = nullptr;
+        Slab* full = nullptr;
+        size_t emptySlabs = 0;
+    };
+
+    static void link(Slab*& list, Slab* slab);
+    static void unlink(Slab*& list, Slab* slab);
+    static size_t classAlignment(size_t classSize) { return classSize & (~classSize + 1); }
+
+    Slab* mapSlab(size_t bytes, size_t objectOffset);
+    void unmapSlab(Slab* slab);
+    void* allocateLarge(size_t size, size_t alignment);
+
+    size_t m_KeepEmptySlabs;
+    std::array<SizeClass, ClassSizes.size()> m_Classes;
+    Slab* m_Large = nullptr;
+    size_t m_MappedBytes = 0;
+    AllocatorStats m_Stats;
+};
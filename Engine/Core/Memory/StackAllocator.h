@@ -7,10 +7,15 @@
 
 class StackMarker {
 public:
-    explicit StackMarker(char* ptr) : m_Ptr(ptr) {}
+    explicit StackMarker(char* ptr, size_t allocated = 0, size_t padding = 0)
+        : m_Ptr(ptr), m_Allocated(allocated), m_Padding(padding) {}
     char* get() const { return m_Ptr; }
+    size_t allocated() const { return m_Allocated; }
+    size_t padding() const { return m_Padding; }
 private:
     char* m_Ptr;
+    size_t m_Allocated;   // stats at the time the marker was taken
+    size_t m_Padding;
 };
 
 class StackAllocator : public Allocator {
@@ -27,19 +32,23 @@ public:
         std::free(m_Start);
     }
 
-    void* allocate(size_t size) override {
-        // Align to 4 bytes
+    using Allocator::allocate;
+
+    void* allocate(size_t size, size_t alignment) override {
+        assert(isValidAlignment(alignment) && "Alignment must be a power of two!");
         uintptr_t currentAddr = reinterpret_cast<uintptr_t>(m_Current);
-        uintptr_t alignedAddr = (currentAddr + 3) & ~static_cast<uintptr_t>(3);
-        char* alignedPtr = reinterpret_cast<char*>(alignedAddr);
+        size_t padding = alignAddress(currentAddr, alignment) - currentAddr;
 
-        if (alignedPtr + size > m_End) return nullptr;
+        size_t remaining = static_cast<size_t>(m_End - m_Current);
+        if (padding > remaining || size > remaining - padding) return nullptr;
 
+        char* alignedPtr = m_Current + padding;
         m_Current = alignedPtr + size;
         m_Stats.totalAllocated += size;
+        m_Stats.paddingBytes += padding;
         m_Stats.allocationCount++;
-        if (m_Stats.totalAllocated > m_Stats.peakUsage)
-            m_Stats.peakUsage = m_Stats.totalAllocated;
+        if (m_Stats.totalAllocated + m_Stats.paddingBytes > m_Stats.peakUsage)
+            m_Stats.peakUsage = m_Stats.totalAllocated + m_Stats.paddingBytes;
 
         return alignedPtr;
     }
@@ -51,20 +60,17 @@ public:
     void reset() override {
         m_Current = m_Start;
 		m_Stats.totalAllocated = 0; // reset current usage
+        m_Stats.paddingBytes = 0;
     }
 
-    StackMarker getMarker() const { return StackMarker(m_Current); }
+    StackMarker getMarker() const { return StackMarker(m_Current, m_Stats.totalAllocated, m_Stats.paddingBytes); }
 
     void freeToMarker(StackMarker marker) {
         if (marker.get() >= m_Start && marker.get() <= m_End) {
-            // Compute how much memory we're "freeing"
-            size_t freed = static_cast<size_t>(m_Current - marker.get());
+            // Everything above the marker goes, padding included
             m_Current = marker.get();
-
-            if (freed <= m_Stats.totalAllocated)
-                m_Stats.totalAllocated -= freed;
-            else
-                m_Stats.totalAllocated = 0;
+            m_Stats.totalAllocated = marker.allocated();
+            m_Stats.paddingBytes = marker.padding();
         }
         else {
             throw std::invalid_argument("Marker out of range");
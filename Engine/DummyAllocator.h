@@ -3,20 +3,38 @@
 #include "Core/Memory/Allocator.h"
 #include <iostream>
 #include <cstdlib>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
 
 
 class DummyAllocator : public Allocator
 {
 public:
 	AllocatorStats m_Stats;
-     void* allocate(size_t size) override
+	using Allocator::allocate;
+
+	// Straight to the CRT; over-aligned requests use its aligned variant
+	void* allocate(size_t size, size_t alignment) override
 	{
-		return std::malloc(size);
+#if defined(_WIN32)
+		// _aligned_free can't release plain malloc blocks, so always go aligned
+		return _aligned_malloc(size, alignment);
+#else
+		if (alignment <= DefaultAlignment)
+			return std::malloc(size);
+		void* ptr = nullptr;
+		return posix_memalign(&ptr, alignment, size) == 0 ? ptr : nullptr;
+#endif
 	}
 
 	void deallocate(void* ptr) override
 	{
-		return std::free(ptr);
+#if defined(_WIN32)
+		_aligned_free(ptr);
+#else
+		std::free(ptr);
+#endif
 	}
 
 	void reset()
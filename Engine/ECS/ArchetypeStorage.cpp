@@ -0,0 +1,185 @@
+#include "pch.h"
+#include "ArchetypeStorage.h"
+#include <algorithm>
+
+static size_t AlignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+Archetype::Archetype(const ComponentSignature& signature,
+    const std::vector<std::unique_ptr<ComponentTypeInfo>>& typeInfos)
+    : m_Signature(signature)
+{
+    std::fill(std::begin(m_ColumnOf), std::end(m_ColumnOf), -1);
+
+    size_t rowBytes = sizeof(EntityID);
+    for (ComponentTypeID type = 0; type < typeInfos.size(); ++type)
+    {
+        if (!signature.test(type))
+            continue;
+
+        m_ColumnOf[type] = static_cast<int>(m_Columns.size());
+        m_Columns.push_back({ type, 0, typeInfos[type].get() });
+        rowBytes += typeInfos[type]->size;
+    }
+
+    // Largest capacity whose aligned SoA layout still fits in one chunk
+    auto layoutBytes = [this](uint32_t capacity) {
+        size_t offset = sizeof(EntityID) * capacity;
+        for (Column& column : m_Columns) {
+            offset = AlignUp(offset, column.info->alignment);
+            column.offset = offset;
+            offset += column.info->size * capacity;
+        }
+        return offset;
+    };
+
+    m_Capacity = static_cast<uint32_t>(ArchetypeChunk::ChunkBytes / rowBytes);
+    while (m_Capacity > 1 && layoutBytes(m_Capacity) > ArchetypeChunk::ChunkBytes)
+        --m_Capacity;
+
+    layoutBytes(m_Capacity);
+    assert(m_Capacity > 0 && "Archetype row does not fit in a chunk!");
+}
+
+Archetype::~Archetype()
+{
+    for (auto& chunk : m_Chunks)
+        for (uint32_t row = 0; row < chunk->count; ++row)
+            for (const Column& column : m_Columns)
+                column.info->destroy(chunk->memory + column.offset + row * column.info->size);
+}
+
+std::pair<uint32_t, uint32_t> Archetype::AllocateRow(EntityID id)
+{
+    if (m_Chunks.empty() || m_Chunks.back()->count == m_Capacity)
+        m_Chunks.push_back(std::make_unique<ArchetypeChunk>());
+
+    uint32_t chunk = static_cast<uint32_t>(m_Chunks.size() - 1);
+    uint32_t row = m_Chunks.back()->count++;
+    GetEntityIDs(*m_Chunks.back())[row] = id;
+    ++m_Size;
+
+    return { chunk, row };
+}
+
+EntityID Archetype::RemoveRow(uint32_t chunk, uint32_t row)
+{
+    uint32_t lastChunk = static_cast<uint32_t>(m_Chunks.size() - 1);
+    uint32_t lastRow = m_Chunks[lastChunk]->count - 1;
+
+    for (int column = 0; column < GetColumnCount(); ++column)
+        m_Columns[column].info->destroy(GetComponentData(chunk, row, column));
+
+    EntityID moved = INVALID_ENTITY;
+    if (chunk != lastChunk || row != lastRow)
+    {
+        for (int column = 0; column < GetColumnCount(); ++column)
+        {
+            void* last = GetComponentData(lastChunk, lastRow, column);
+            m_Columns[column].info->moveConstruct(GetComponentData(chunk, row, column), last);
+            m_Columns[column].info->destroy(last);
+        }
+
+        moved = GetEntityIDs(*m_Chunks[lastChunk])[lastRow];
+        GetEntityIDs(*m_Chunks[chunk])[row] = moved;
+    }
+
+    if (--m_Chunks[lastChunk]->count == 0)
+        m_Chunks.pop_back();
+
+    --m_Size;
+    return moved;
+}
+
+std::vector<Archetype*> ArchetypeStorage::Query(const ComponentSignature& required) const
+{
+    std::vector<Archetype*> result;
+    for (const auto& [signature, archetype] : m_Archetypes)
+    {
+        if ((signature & required) == required && archetype->Size() > 0)
+            result.push_back(archetype.get());
+    }
+    return result;
+}
+
+void ArchetypeStorage::EntityDestroyed(Entity entity)
+{
+    if (!FindLocation(entity))
+        return;
+
+    MoveEntity(entity.id, nullptr);
+}
+
+void ArchetypeStorage::Clear()
+{
+    m_Archetypes.clear();
+    m_Locations.clear();
+}
+
+ArchetypeStorage::EntityLocation& ArchetypeStorage::LocationSlot(uint32_t entityIndex)
+{
+    if (entityIndex >= m_Locations.size())
+        m_Locations.resize(static_cast<size_t>(entityIndex) + 1);
+    return m_Locations[entityIndex];
+}
+
+const ArchetypeStorage::EntityLocation* ArchetypeStorage::FindLocation(Entity entity) const
+{
+    if (entity.Index() >= m_Locations.size())
+        return nullptr;
+
+    const EntityLocation& location = m_Locations[entity.Index()];
+    if (!location.archetype)
+        return nullptr;
+
+    const ArchetypeChunk& chunk = location.archetype->GetChunk(location.chunk);
+    return location.archetype->GetEntityIDs(chunk)[location.row] == entity.id ? &location : nullptr;
+}
+
+Archetype* ArchetypeStorage::GetOrCreateArchetype(const ComponentSignature& signature)
+{
+    auto& slot = m_Archetypes[signature];
+    if (!slot)
+        slot = std::make_unique<Archetype>(signature, m_TypeInfos);
+    return slot.get();
+}
+
+void ArchetypeStorage::MoveEntity(EntityID id, Archetype* target)
+{
+    EntityLocation& location = LocationSlot(GetEntityIndex(id));
+    EntityLocation destination;
+
+    if (target)
+    {
+        auto [chunk, row] = target->AllocateRow(id);
+        destination = { target, chunk, row };
+    }
+
+    if (Archetype* source = location.archetype)
+    {
+        if (target)
+        {
+            for (int column = 0; column < source->GetColumnCount(); ++column)
+            {
+                int targetColumn = target->GetColumn(source->GetColumnType(column));
+                if (targetColumn < 0)
+                    continue;
+
+                source->GetColumnInfo(column)->moveConstruct(
+                    target->GetComponentData(destination.chunk, destination.row, targetColumn),
+                    source->GetComponentData(location.chunk, location.row, column));
+            }
+        }
+
+        EntityID moved = source->RemoveRow(location.chunk, location.row);
+        if (moved != INVALID_ENTITY)
+        {
+            m_Locations[GetEntityIndex(moved)].chunk = location.chunk;
+            m_Locations[GetEntityIndex(moved)].row = location.row;
+        }
+    }
+
+    location = destination;
+}
@@ -0,0 +1,283 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <bitset>
+#include <unordered_map>
+#include <new>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <stdexcept>
+#include "Entity.h"
+#include "ComponentTypeId.h"
+
+// Archetype-local type id (0..63, a bit in ComponentSignature). Each
+// storage maps the process-wide ComponentTypeId<T>() onto one.
+using ComponentTypeID = uint32_t;
+constexpr ComponentTypeID MaxComponentTypes = 64;
+constexpr ComponentTypeID InvalidComponentTypeID = 0xFFFFFFFF;
+using ComponentSignature = std::bitset<MaxComponentTypes>;
+
+// Type-erased lifetime operations for one registered component type
+struct ComponentTypeInfo
+{
+    size_t size = 0;
+    size_t alignment = 0;
+    void (*moveConstruct)(void* dst, void* src) = nullptr;
+    void (*destroy)(void* ptr) = nullptr;
+};
+
+// ------------------------------------------------------------
+// ArchetypeChunk - one fixed 16 KB block of SoA rows
+// ------------------------------------------------------------
+struct ArchetypeChunk
+{
+    static constexpr size_t ChunkBytes = 16 * 1024;
+    static constexpr size_t ChunkAlignment = 64;   // cache line
+
+    ArchetypeChunk()
+        : memory(static_cast<std::byte*>(::operator new(ChunkBytes, std::align_val_t{ ChunkAlignment }))) {
+    }
+
+    ~ArchetypeChunk() { ::operator delete(memory, std::align_val_t{ ChunkAlignment }); }
+
+    ArchetypeChunk(const ArchetypeChunk&) = delete;
+    ArchetypeChunk& operator=(const ArchetypeChunk&) = delete;
+
+    std::byte* memory;
+    uint32_t count = 0;
+};
+
+// ------------------------------------------------------------
+// Archetype - every entity sharing one component signature
+//
+// Chunk layout: [EntityID x capacity][column 0 x capacity][column 1 ...]
+// so each component type is a contiguous array inside the chunk.
+// Rows stay packed: removing a row moves the archetype's last row
+// into the hole.
+// ------------------------------------------------------------
+class Archetype
+{
+public:
+    Archetype(const ComponentSignature& signature,
+        const std::vector<std::unique_ptr<ComponentTypeInfo>>& typeInfos);
+    ~Archetype();
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    const ComponentSignature& GetSignature() const { return m_Signature; }
+    uint32_t GetCapacity() const { return m_Capacity; }
+    size_t Size() const { return m_Size; }
+
+    size_t GetChunkCount() const { return m_Chunks.size(); }
+    ArchetypeChunk& GetChunk(size_t index) const { return *m_Chunks[index]; }
+
+    // Column index of a component type, or -1 if this archetype lacks it
+    int GetColumn(ComponentTypeID type) const { return m_ColumnOf[type]; }
+
+    EntityID* GetEntityIDs(const ArchetypeChunk& chunk) const {
+        return reinterpret_cast<EntityID*>(chunk.memory);
+    }
+
+    void* GetColumnData(const ArchetypeChunk& chunk, int column) const {
+        return chunk.memory + m_Columns[column].offset;
+    }
+
+    void* GetComponentData(uint32_t chunk, uint32_t row, int column) const {
+        return static_cast<std::byte*>(GetColumnData(*m_Chunks[chunk], column))
+            + row * m_Columns[column].info->size;
+    }
+
+    // Appends an uninitialised row for id; returns { chunk, row }
+    std::pair<uint32_t, uint32_t> AllocateRow(EntityID id);
+
+    // Destroys the row and back-fills it with the last row.
+    // Returns the entity that moved into (chunk, row), or INVALID_ENTITY.
+    EntityID RemoveRow(uint32_t chunk, uint32_t row);
+
+    int GetColumnCount() const { return static_cast<int>(m_Columns.size()); }
+    ComponentTypeID GetColumnType(int column) const { return m_Columns[column].type; }
+    const ComponentTypeInfo* GetColumnInfo(int column) const { return m_Columns[column].info; }
+
+    // Cached neighbours in the archetype graph (signature with one type toggled)
+    Archetype*& AddEdge(ComponentTypeID type) { return m_AddEdges[type]; }
+    Archetype*& RemoveEdge(ComponentTypeID type) { return m_RemoveEdges[type]; }
+
+private:
+    struct Column {
+        ComponentTypeID type;
+        size_t offset;
+        const ComponentTypeInfo* info;
+    };
+
+    ComponentSignature m_Signature;
+    std::vector<Column> m_Columns;
+    int m_ColumnOf[MaxComponentTypes];
+    Archetype* m_AddEdges[MaxComponentTypes] = {};
+    Archetype* m_RemoveEdges[MaxComponentTypes] = {};
+    uint32_t m_Capacity = 0;
+    size_t m_Size = 0;
+    std::vector<std::unique_ptr<ArchetypeChunk>> m_Chunks;
+};
+
+// ------------------------------------------------------------
+// ArchetypeStorage - groups entities by component signature
+//
+// Adding or removing a component is a structural move: the entity's
+// row is moved to the archetype for its new signature.
+// ------------------------------------------------------------
+class ArchetypeStorage
+{
+public:
+    template<typename T>
+    void RegisterComponent()
+    {
+        if (IsRegistered<T>())
+            return;
+
+        assert(m_TypeInfos.size() < MaxComponentTypes && "Too many component types!");
+        static_assert(sizeof(T) <= ArchetypeChunk::ChunkBytes / 2, "Component too large for an archetype chunk");
+
+        auto info = std::make_unique<ComponentTypeInfo>();
+        info->size = sizeof(T);
+        info->alignment = alignof(T);
+        info->moveConstruct = [](void* dst, void* src) { new (dst) T(std::move(*static_cast<T*>(src))); };
+        info->destroy = [](void* ptr) { static_cast<T*>(ptr)->~T(); };
+
+        ComponentTypeIndex global = ComponentTypeId<T>();
+        if (global >= m_TypeIDs.size())
+            m_TypeIDs.resize(global + 1, InvalidComponentTypeID);
+
+        m_TypeIDs[global] = static_cast<ComponentTypeID>(m_TypeInfos.size());
+        m_TypeInfos.push_back(std::move(info));
+    }
+
+    template<typename T>
+    ComponentTypeID GetTypeID() const
+    {
+        ComponentTypeID type = FindTypeID<T>();
+        if (type == InvalidComponentTypeID)
+            throw std::out_of_range("Component not registered!");
+        return type;
+    }
+
+    template<typename T>
+    void AddComponent(Entity entity, const T& component)
+    {
+        assert(!HasComponent<T>(entity) && "Component already exists!");
+        ComponentTypeID type = GetTypeID<T>();
+
+        Archetype* source = LocationSlot(entity.Index()).archetype;
+        assert((!source || FindLocation(entity)) && "A destroyed entity still owns this index!");
+        Archetype* target = source ? source->AddEdge(type) : nullptr;
+        if (!target)
+        {
+            ComponentSignature signature = source ? source->GetSignature() : ComponentSignature{};
+            signature.set(type);
+            target = GetOrCreateArchetype(signature);
+            if (source)
+                source->AddEdge(type) = target;
+        }
+
+        MoveEntity(entity.id, target);
+
+        const EntityLocation& moved = m_Locations[entity.Index()];
+        new (target->GetComponentData(moved.chunk, moved.row, target->GetColumn(type))) T(component);
+    }
+
+    template<typename T>
+    void RemoveComponent(Entity entity)
+    {
+        assert(HasComponent<T>(entity) && "Component does not exist!");
+        ComponentTypeID type = GetTypeID<T>();
+        Archetype* source = m_Locations[entity.Index()].archetype;
+        Archetype* target = source->RemoveEdge(type);
+        if (!target)
+        {
+            ComponentSignature signature = source->GetSignature();
+            signature.reset(type);
+            if (signature.any())
+                target = source->RemoveEdge(type) = GetOrCreateArchetype(signature);
+        }
+
+        MoveEntity(entity.id, target);
+    }
+
+    template<typename T>
+    T& GetComponent(Entity entity)
+    {
+        assert(HasComponent<T>(entity) && "Component does not exist!");
+        const EntityLocation& location = m_Locations[entity.Index()];
+        Archetype* archetype = location.archetype;
+        return *static_cast<T*>(archetype->GetComponentData(
+            location.chunk, location.row, archetype->GetColumn(GetTypeID<T>())));
+    }
+
+    template<typename T>
+    const T& GetComponent(Entity entity) const
+    {
+        if (!HasComponent<T>(entity))
+            throw std::out_of_range("Component does not exist!");
+
+        const EntityLocation& location = m_Locations[entity.Index()];
+        Archetype* archetype = location.archetype;
+        return *static_cast<const T*>(archetype->GetComponentData(
+            location.chunk, location.row, archetype->GetColumn(GetTypeID<T>())));
+    }
+
+    template<typename T>
+    bool HasComponent(Entity entity) const
+    {
+        ComponentTypeID type = FindTypeID<T>();
+        if (type == InvalidComponentTypeID)
+            return false;
+
+        const EntityLocation* location = FindLocation(entity);
+        return location && location->archetype->GetSignature().test(type);
+    }
+
+    template<typename T>
+    bool IsRegistered() const
+    {
+        return FindTypeID<T>() != InvalidComponentTypeID;
+    }
+
+    // Every archetype whose signature contains all of 'required'
+    std::vector<Archetype*> Query(const ComponentSignature& required) const;
+
+    void EntityDestroyed(Entity entity);
+    void Clear();
+
+    size_t GetArchetypeCount() const { return m_Archetypes.size(); }
+
+private:
+    struct EntityLocation {
+        Archetype* archetype = nullptr;
+        uint32_t chunk = 0;
+        uint32_t row = 0;
+    };
+
+    std::vector<std::unique_ptr<ComponentTypeInfo>> m_TypeInfos;    // indexed by ComponentTypeID
+    std::vector<ComponentTypeID> m_TypeIDs;                          // indexed by ComponentTypeId<T>()
+    std::unordered_map<ComponentSignature, std::unique_ptr<Archetype>> m_Archetypes;
+    std::vector<EntityLocation> m_Locations;                         // indexed by entity index
+
+    EntityLocation& LocationSlot(uint32_t entityIndex);
+
+    template<typename T>
+    ComponentTypeID FindTypeID() const
+    {
+        ComponentTypeIndex global = ComponentTypeId<T>();
+        return global < m_TypeIDs.size() ? m_TypeIDs[global] : InvalidComponentTypeID;
+    }
+
+    // Location of a live handle, nullptr if it has no components or is stale
+    const EntityLocation* FindLocation(Entity entity) const;
+    Archetype* GetOrCreateArchetype(const ComponentSignature& signature);
+
+    // Moves the entity's row into target (nullptr = no components left).
+    // Shared columns are moved, columns target lacks are destroyed.
+    void MoveEntity(EntityID id, Archetype* target);
+};
@@ -1,7 +1,10 @@
 #pragma once
-#include <unordered_map>
 #include <vector>
+#include <memory>
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <stdexcept>
 #include "../ECS/Entity.h"
 
 
@@ -9,65 +12,197 @@ struct IComponentArray
 {
     virtual ~IComponentArray() = default;
     virtual void Clear() = 0;
+    virtual void EntityDestroyed(Entity entity) = 0;
+
+    // Change tracking: the tick stamped by inserts and MarkChanged
+    virtual void SetTick(uint32_t tick) = 0;
+    virtual uint32_t GetLastChangedTick() const = 0;
 };
 
 // ------------------------------------------------------------
 // ComponentArray<T>  tightly-packed storage for one component type
+//
+// Sparse set: a paged sparse array maps entity index -> dense index,
+// and a dense entity array runs parallel to the dense components.
+// Lookups are two indexed loads, iteration is a linear walk. The
+// dense entity array holds full handles, so a stale handle (older
+// generation) never matches.
+//
+// Change tracking: a third dense array records the tick at which each
+// component was inserted or last passed to MarkChanged. Writers must
+// call MarkChanged themselves; plain mutable access does not count,
+// since views hand out references to everything.
 // ------------------------------------------------------------
 template<typename T>
-class ComponentArray : public IComponentArray 
+class ComponentArray : public IComponentArray
 {
 public:
+    static constexpr uint32_t PageSize = 4096;             // sparse entries per page
+    static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
     void InsertData(Entity entity, const T& component) {
-        assert(m_EntityToIndex.find(entity.id) == m_EntityToIndex.end() && "Component already exists!");
-        size_t index = m_Size;
-        m_EntityToIndex[entity.id] = index;
-        if (index >= m_Components.size()) m_Components.resize(index + 1);
-        m_Components[index] = component;
-        m_IndexToEntity[index] = entity.id;
-        ++m_Size;
+        uint32_t& slot = SparseSlot(entity.Index());
+        assert(slot == InvalidIndex && "Component already exists (or a destroyed entity still owns this index)!");
+        slot = static_cast<uint32_t>(m_Components.size());
+        m_Components.push_back(component);
+        m_Entities.push_back(entity.id);
+        m_ChangedTicks.push_back(m_Tick);
+        m_LastChangedTick = m_Tick;
+    }
+
+    // Appends count components in one go: storage is reserved once and
+    // every sparse page the batch touches is allocated up front
+    void InsertBatch(const Entity* entities, const T* components, size_t count) {
+        if (count == 0)
+            return;
+
+        // First pass: grow the page table once, then fill in every page
+        // the batch lands on, so the insert loop below never allocates
+        uint32_t maxIndex = 0;
+        for (size_t i = 0; i < count; ++i)
+            maxIndex = std::max(maxIndex, entities[i].Index());
+        if (maxIndex / PageSize >= m_Sparse.size())
+            m_Sparse.resize(maxIndex / PageSize + 1);
+        for (size_t i = 0; i < count; ++i)
+            EnsurePage(entities[i].Index() / PageSize);
+
+        m_Components.reserve(m_Components.size() + count);
+        m_Entities.reserve(m_Entities.size() + count);
+        m_ChangedTicks.resize(m_ChangedTicks.size() + count, m_Tick);
+        m_LastChangedTick = m_Tick;
+
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t index = entities[i].Index();
+            uint32_t& slot = m_Sparse[index / PageSize][index % PageSize];
+            assert(slot == InvalidIndex && "Component already exists (or a destroyed entity still owns this index)!");
+            slot = static_cast<uint32_t>(m_Entities.size());
+            m_Entities.push_back(entities[i].id);
+        }
+        m_Components.insert(m_Components.end(), components, components + count);
     }
 
     void RemoveData(Entity entity) {
-        assert(m_EntityToIndex.find(entity.id) != m_EntityToIndex.end() && "Component does not exist!");
-        size_t removedIndex = m_EntityToIndex[entity.id];
-        size_t lastIndex = m_Size - 1;
-        m_Components[removedIndex] = m_Components[lastIndex];
-        EntityID lastEntity = m_IndexToEntity[lastIndex];
-        m_EntityToIndex[lastEntity] = removedIndex;
-        m_IndexToEntity[removedIndex] = lastEntity;
-        m_EntityToIndex.erase(entity.id);
-        m_IndexToEntity.erase(lastIndex);
-        --m_Size;
+        assert(HasData(entity) && "Component does not exist!");
+        uint32_t removedIndex = DenseIndex(entity.id);
+        uint32_t lastIndex = static_cast<uint32_t>(m_Components.size() - 1);
+
+        // Swap-remove: move the last element into the hole
+        if (removedIndex != lastIndex) {
+            EntityID lastEntity = m_Entities[lastIndex];
+            m_Components[removedIndex] = std::move(m_Components[lastIndex]);
+            m_Entities[removedIndex] = lastEntity;
+            m_ChangedTicks[removedIndex] = m_ChangedTicks[lastIndex];
+            SparseSlot(GetEntityIndex(lastEntity)) = removedIndex;
+        }
+
+        SparseSlot(entity.Index()) = InvalidIndex;
+        m_LastChangedTick = m_Tick;   // a removal still dirties the array
+        m_Components.pop_back();
+        m_Entities.pop_back();
+        m_ChangedTicks.pop_back();
     }
 
     T& GetData(Entity entity) {
-        assert(m_EntityToIndex.find(entity.id) != m_EntityToIndex.end() && "Component does not exist!");
-        return m_Components[m_EntityToIndex[entity.id]];
+        assert(HasData(entity) && "Component does not exist!");
+        return m_Components[DenseIndex(entity.id)];
     }
 
     void Clear() override
     {
         m_Components.clear();
-        m_EntityToIndex.clear();
-        m_IndexToEntity.clear();
+        m_Entities.clear();
+        m_ChangedTicks.clear();
+        m_Sparse.clear();
+        m_LastChangedTick = m_Tick;   // everything that was there is gone
+    }
+
+    void EntityDestroyed(Entity entity) override
+    {
+        if (HasData(entity))
+            RemoveData(entity);
     }
 
     const T& GetData(Entity entity) const {
-        return m_Components[m_EntityToIndex.at(entity.id)];
+        uint32_t index = DenseIndex(entity.id);
+        if (index == InvalidIndex)
+            throw std::out_of_range("Component does not exist!");
+        return m_Components[index];
     }
 
     bool HasData(Entity entity) const {
-        return m_EntityToIndex.find(entity.id) != m_EntityToIndex.end();
+        return DenseIndex(entity.id) != InvalidIndex;
     }
 
+    size_t Size() const { return m_Components.size(); }
+
     std::vector<T>& GetRaw() { return m_Components; }
 
+    // Dense entity list, parallel to GetRaw()
+    const std::vector<EntityID>& GetEntities() const { return m_Entities; }
+
+    // ---- Change tracking ----
+    void SetTick(uint32_t tick) override { m_Tick = tick; }
+    uint32_t GetLastChangedTick() const override { return m_LastChangedTick; }
+
+    void MarkChanged(Entity entity) {
+        assert(HasData(entity) && "Component does not exist!");
+        m_ChangedTicks[DenseIndex(entity.id)] = m_Tick;
+        m_LastChangedTick = m_Tick;
+    }
+
+    uint32_t GetChangedTick(Entity entity) const {
+        uint32_t index = DenseIndex(entity.id);
+        return index == InvalidIndex ? 0 : m_ChangedTicks[index];
+    }
+
+    // Calls fn(Entity, T&) for every component inserted or marked at
+    // 'tick' or later. Skips the scan entirely when nothing qualifies.
+    template<typename Func>
+    void ForEachChangedSince(uint32_t tick, Func&& fn) {
+        if (m_LastChangedTick < tick)
+            return;
+
+        for (size_t i = 0; i < m_ChangedTicks.size(); ++i)
+            if (m_ChangedTicks[i] >= tick)
+                fn(Entity{ m_Entities[i] }, m_Components[i]);
+    }
+
 
 
 private:
     std::vector<T> m_Components;
-    std::unordered_map<EntityID, size_t> m_EntityToIndex;
-    std::unordered_map<size_t, EntityID> m_IndexToEntity;
-    size_t m_Size = 0;
+    std::vector<EntityID> m_Entities;
+    std::vector<uint32_t> m_ChangedTicks;                 // parallel to m_Components
+    std::vector<std::unique_ptr<uint32_t[]>> m_Sparse;
+    uint32_t m_Tick = 1;
+    uint32_t m_LastChangedTick = 0;
+
+    // Dense index for a handle, InvalidIndex if absent or stale
+    uint32_t DenseIndex(EntityID id) const {
+        uint32_t entityIndex = GetEntityIndex(id);
+        size_t page = entityIndex / PageSize;
+        if (page >= m_Sparse.size() || !m_Sparse[page])
+            return InvalidIndex;
+
+        uint32_t dense = m_Sparse[page][entityIndex % PageSize];
+        return (dense != InvalidIndex && m_Entities[dense] == id) ? dense : InvalidIndex;
+    }
+
+    // Allocates a sparse page (all InvalidIndex) unless it exists; the
+    // page table must already reach it
+    void EnsurePage(size_t page) {
+        if (!m_Sparse[page]) {
+            m_Sparse[page] = std::make_unique<uint32_t[]>(PageSize);
+            std::fill(m_Sparse[page].get(), m_Sparse[page].get() + PageSize, InvalidIndex);
+        }
+    }
+
+    // Returns the sparse slot for an entity index, allocating its page on first use
+    uint32_t& SparseSlot(uint32_t entityIndex) {
+        size_t page = entityIndex / PageSize;
+        if (page >= m_Sparse.size())
+            m_Sparse.resize(page + 1);
+        EnsurePage(page);
+        return m_Sparse[page][entityIndex % PageSize];
+    }
 };
@@ -1,128 +1,296 @@
 #pragma once
 #include <memory>
-#include <unordered_map>
-#include <typeindex>
+#include <vector>
+#include <string>
+#include <typeinfo>
+#include "ComponentTypeId.h"
 #include "ComponentArray.h"
+#include "ComponentView.h"
+#include "ArchetypeStorage.h"
 #include <iostream>
 
 // ------------------------------------------------------------
 // ComponentManager  owns all component arrays by type
+//
+// Arrays are found through ComponentTypeId<T>(), which indexes a flat
+// table of raw pointers: one indexed load per lookup, no hashing and
+// no reference counting.
 // ------------------------------------------------------------
+
+// Backing storage, chosen once per ComponentManager
+enum class ComponentStorage
+{
+    SparseSet,   // one ComponentArray per type (default)
+    Archetype    // entities grouped by signature into 16 KB SoA chunks
+};
+
 class ComponentManager {
 public:
+    explicit ComponentManager(ComponentStorage storage = ComponentStorage::SparseSet)
+        : m_Storage(storage) {
+    }
+
+    ComponentStorage GetStorage() const { return m_Storage; }
+
     template<typename T>
     void RegisterComponent(const char* debugName = nullptr)
     {
-        std::type_index ti = typeid(T);
+        const char* name = debugName ? debugName : typeid(T).name();
 
-        if (m_ComponentArrays.find(ti) != m_ComponentArrays.end())
+        if (IsComponentRegistered<T>())
         {
             std::cerr
                 << "[ComponentManager] "
-                << (debugName ? debugName : ti.name())
+                << name
                 << " already registered\n";
             return;
         }
 
         std::cerr
             << "[ComponentManager] Registering "
-            << (debugName ? debugName : ti.name())
+            << name
             << "...\n";
 
-        m_ComponentArrays[ti] =
-            std::make_shared<ComponentArray<T>>();
+        ComponentTypeIndex type = ComponentTypeId<T>();
+        if (type >= m_ArraysByType.size())
+            m_ArraysByType.resize(type + 1, nullptr);
+
+        m_ComponentArrays.push_back(std::make_unique<ComponentArray<T>>());
+        m_ComponentArrays.back()->SetTick(m_Tick);
+        m_ComponentNames.push_back(name);
+        m_ArraysByType[type] = m_ComponentArrays.back().get();
+        m_Archetypes.RegisterComponent<T>();
 
         std::cerr
             << "[ComponentManager] "
-            << (debugName ? debugName : ti.name())
+            << name
             << " registered OK\n";
     }
 
     template<typename T>
     void AddComponent(Entity entity, const T& component)
     {
+        if (m_Storage == ComponentStorage::Archetype)
+            return m_Archetypes.AddComponent(entity, component);
+
         GetArray<T>()->InsertData(entity, component);
     }
 
+    // Bulk insert for loaders: one array lookup and one reservation for
+    // the whole batch. Archetype storage still moves entity by entity.
+    template<typename T>
+    void AddComponents(const Entity* entities, const T* components, size_t count)
+    {
+        if (m_Storage == ComponentStorage::Archetype)
+        {
+            for (size_t i = 0; i < count; ++i)
+                m_Archetypes.AddComponent(entities[i], components[i]);
+            return;
+        }
+
+        GetArray<T>()->InsertBatch(entities, components, count);
+    }
+
+    template<typename T>
+    void AddComponents(const std::vector<Entity>& entities, const std::vector<T>& components)
+    {
+        assert(entities.size() == components.size() && "One component per entity!");
+        AddComponents(entities.data(), components.data(), entities.size());
+    }
+
     template<typename T>
     void RemoveComponent(Entity entity)
     {
+        if (m_Storage == ComponentStorage::Archetype)
+            return m_Archetypes.RemoveComponent<T>(entity);
+
         GetArray<T>()->RemoveData(entity);
     }
 
     template<typename T>
     T& GetComponent(Entity entity)
     {
+        if (m_Storage == ComponentStorage::Archetype)
+            return m_Archetypes.GetComponent<T>(entity);
+
         return GetArray<T>()->GetData(entity);
     }
 
     template<typename T>
     const T& GetComponent(Entity entity) const
     {
+        if (m_Storage == ComponentStorage::Archetype)
+            return m_Archetypes.GetComponent<T>(entity);
+
         return GetArray<T>()->GetData(entity);
     }
 
+    // Sparse-set storage only: archetype mode has no single array per type
     template<typename T>
     std::vector<T>& GetAll()
     {
+        assert(m_Storage == ComponentStorage::SparseSet && "GetAll needs sparse-set storage");
         return GetArray<T>()->GetRaw();
     }
 
+    // Iterates every entity owning all of Ts: driven by the smallest array
+    // in sparse-set mode, by the matching archetypes' chunks otherwise
+    template<typename... Ts>
+    ComponentView<Ts...> View()
+    {
+        if (m_Storage == ComponentStorage::Archetype)
+        {
+            if (!(m_Archetypes.IsRegistered<Ts>() && ...))
+                return ComponentView<Ts...>(std::vector<Archetype*>{}, {});
+
+            std::array<ComponentTypeID, sizeof...(Ts)> types{ m_Archetypes.GetTypeID<Ts>()... };
+            ComponentSignature required;
+            for (ComponentTypeID type : types)
+                required.set(type);
+
+            return ComponentView<Ts...>(m_Archetypes.Query(required), types);
+        }
+
+        return ComponentView<Ts...>(FindArray<Ts>()...);
+    }
+
+    // Drops every component owned by a destroyed entity
+    void EntityDestroyed(Entity entity)
+    {
+        if (m_Storage == ComponentStorage::Archetype)
+            return m_Archetypes.EntityDestroyed(entity);
+
+        for (auto& array : m_ComponentArrays)
+            array->EntityDestroyed(entity);
+    }
+
     // Clears ALL component data (used for Play Mode transitions)
     void Clear()
     {
-        for (auto& [type, array] : m_ComponentArrays)
+        for (auto& array : m_ComponentArrays)
             array->Clear();
+        m_Archetypes.Clear();
+    }
+
+    // ---------------- Change tracking ----------------
+    // Ticks count frames (AdvanceTick once per frame). Inserts and
+    // MarkChanged stamp the current tick; a consumer remembers the tick
+    // it last ran at and asks for everything changed since then.
+    // "Since" is inclusive, so writes made later in the same tick are
+    // seen on the next run rather than lost.
+    // Archetype storage does not track changes: queries report every
+    // entity that has the component.
+
+    uint32_t GetTick() const { return m_Tick; }
+
+    void AdvanceTick()
+    {
+        ++m_Tick;
+        for (auto& array : m_ComponentArrays)
+            array->SetTick(m_Tick);
     }
 
     template<typename T>
-    bool HasComponent(Entity entity) const
+    void MarkChanged(Entity entity)
+    {
+        if (m_Storage == ComponentStorage::SparseSet)
+            GetArray<T>()->MarkChanged(entity);
+    }
+
+    // Calls fn(Entity, T&) for each T inserted or marked at 'tick' or later
+    template<typename T, typename Func>
+    void ForEachChangedSince(uint32_t tick, Func&& fn)
+    {
+        if (m_Storage == ComponentStorage::Archetype)
+        {
+            View<T>().ForEach(fn);
+            return;
+        }
+
+        if (ComponentArray<T>* array = FindArray<T>())
+            array->ForEachChangedSince(tick, fn);
+    }
+
+    // True if any component was inserted, marked or removed at 'tick' or later
+    bool AnyChangedSince(uint32_t tick) const
     {
-        auto it = m_ComponentArrays.find(std::type_index(typeid(T)));
-        if (it == m_ComponentArrays.end())
-            return false;
+        if (m_Storage == ComponentStorage::Archetype)
+            return true;
+
+        for (const auto& array : m_ComponentArrays)
+            if (array->GetLastChangedTick() >= tick)
+                return true;
+        return false;
+    }
 
-        auto array =
-            static_cast<const ComponentArray<T>*>(it->second.get());
+    template<typename T>
+    bool HasComponent(Entity entity) const
+    {
+        if (m_Storage == ComponentStorage::Archetype)
+            return m_Archetypes.HasComponent<T>(entity);
 
-        return array->HasData(entity);
+        const ComponentArray<T>* array = FindArray<T>();
+        return array && array->HasData(entity);
     }
     template<typename T>
     bool IsComponentRegistered() const
     {
-        return m_ComponentArrays.find(
-            std::type_index(typeid(T))
-        ) != m_ComponentArrays.end();
+        return FindArray<T>() != nullptr;
     }
 
     void DumpRegisteredComponents() const
     {
         std::cerr << "---- Registered Components ----\n";
 
-        for (const auto& [type, array] : m_ComponentArrays)
+        for (const std::string& name : m_ComponentNames)
         {
-            std::cerr << "  " << type.name() << "\n";
+            std::cerr << "  " << name << "\n";
         }
 
         std::cerr << "--------------------------------\n";
     }
 
 private:
-    std::unordered_map<std::type_index, std::shared_ptr<IComponentArray>> m_ComponentArrays;
+    ComponentStorage m_Storage;
+    uint32_t m_Tick = 1;
+    std::vector<std::unique_ptr<IComponentArray>> m_ComponentArrays;   // registration order
+    std::vector<std::string> m_ComponentNames;                         // parallel to m_ComponentArrays
+    std::vector<IComponentArray*> m_ArraysByType;                      // indexed by ComponentTypeId, nullptr if unregistered
+    ArchetypeStorage m_Archetypes;
 
     template<typename T>
-    std::shared_ptr<ComponentArray<T>> GetArray()
+    ComponentArray<T>* GetArray()
     {
-        return std::static_pointer_cast<ComponentArray<T>>(
-            m_ComponentArrays.at(std::type_index(typeid(T)))
-        );
+        ComponentArray<T>* array = FindArray<T>();
+        assert(array && "Component not registered!");
+        return array;
     }
 
     template<typename T>
-    std::shared_ptr<const ComponentArray<T>> GetArray() const
+    const ComponentArray<T>* GetArray() const
     {
-        return std::static_pointer_cast<const ComponentArray<T>>(
-            m_ComponentArrays.at(std::type_index(typeid(T)))
-        );
+        const ComponentArray<T>* array = FindArray<T>();
+        if (!array)
+            throw std::out_of_range("Component not registered!");
+        return array;
     }
-};
+
+    // Raw lookup that tolerates unregistered types (returns nullptr)
+    template<typename T>
+    ComponentArray<T>* FindArray()
+    {
+        ComponentTypeIndex type = ComponentTypeId<T>();
+        return type < m_ArraysByType.size()
+            ? static_cast<ComponentArray<T>*>(m_ArraysByType[type])
+            : nullptr;
+    }
+
+    template<typename T>
+    const ComponentArray<T>* FindArray() const
+    {
+        ComponentTypeIndex type = ComponentTypeId<T>();
+        return type < m_ArraysByType.size()
+            ? static_cast<const ComponentArray<T>*>(m_ArraysByType[type])
+            : nullptr;
+    }
+};
\ No newline at end of file
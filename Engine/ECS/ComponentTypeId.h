@@ -0,0 +1,28 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// ------------------------------------------------------------
+// ComponentTypeId<T>() - dense, process-wide index per component type
+//
+// Ids are handed out 0, 1, 2... the first time each type is asked for,
+// so they can index flat arrays directly. The value is not stable
+// between runs; never serialize it.
+// ------------------------------------------------------------
+using ComponentTypeIndex = uint32_t;
+
+namespace Detail
+{
+    inline ComponentTypeIndex NextComponentTypeId()
+    {
+        static std::atomic<ComponentTypeIndex> s_Next{ 0 };
+        return s_Next.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+template<typename T>
+inline ComponentTypeIndex ComponentTypeId()
+{
+    static const ComponentTypeIndex s_Id = Detail::NextComponentTypeId();
+    return s_Id;
+}
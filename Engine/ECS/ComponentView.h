@@ -0,0 +1,204 @@
+#pragma once
+#include <tuple>
+#include <array>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include "ComponentArray.h"
+#include "ArchetypeStorage.h"
+
+// ------------------------------------------------------------
+// ComponentView<Ts...> - iterates entities that own every Ts
+//
+// Sparse-set mode walks the dense entity list of the smallest
+// participating ComponentArray and skips entities missing any other
+// Ts, so the cost scales with the rarest component rather than
+// entity count. Archetype mode walks the chunks of every matching
+// archetype, where each Ts is already a contiguous column.
+//
+//   for (auto [e, physics, transform] : cm.View<PhysicsComponent, TransformComponent>())
+//   cm.View<ScriptComponent>().ForEach([](Entity e, ScriptComponent& sc) { ... });
+// ------------------------------------------------------------
+template<typename... Ts>
+class ComponentView
+{
+public:
+    static_assert(sizeof...(Ts) > 0, "ComponentView needs at least one component type");
+
+    using Row = std::tuple<Entity, Ts&...>;
+    using ColumnIndices = std::array<int, sizeof...(Ts)>;
+
+    // Any null array (unregistered component) yields an empty view
+    explicit ComponentView(ComponentArray<Ts>*... arrays)
+        : m_Arrays(arrays...)
+    {
+        if (!((arrays != nullptr) && ...))
+            return;
+
+        size_t smallest = static_cast<size_t>(-1);
+        ((arrays->Size() < smallest
+            ? (smallest = arrays->Size(), m_Driver = &arrays->GetEntities(), 0)
+            : 0), ...);
+    }
+
+    // Archetype mode: 'archetypes' must all contain every Ts
+    ComponentView(std::vector<Archetype*> archetypes, const std::array<ComponentTypeID, sizeof...(Ts)>& types)
+        : m_Archetypal(true), m_Archetypes(std::move(archetypes))
+    {
+        m_Columns.reserve(m_Archetypes.size());
+        for (Archetype* archetype : m_Archetypes)
+        {
+            ColumnIndices columns;
+            for (size_t i = 0; i < types.size(); ++i)
+                columns[i] = archetype->GetColumn(types[i]);
+            m_Columns.push_back(columns);
+        }
+    }
+
+    class Iterator
+    {
+    public:
+        Iterator(const ComponentView* view, size_t index, size_t archetype = 0, size_t chunk = 0)
+            : m_View(view), m_Index(index), m_Archetype(archetype), m_Chunk(chunk) { Settle(); }
+
+        Row operator*() const {
+            if (m_View->m_Archetypal)
+                return m_View->MakeArchetypeRow(m_Archetype, m_Chunk, m_Index);
+
+            Entity e{ (*m_View->m_Driver)[m_Index] };
+            return m_View->MakeRow(e);
+        }
+
+        Iterator& operator++() {
+            ++m_Index;
+            Settle();
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return m_Index == other.m_Index && m_Archetype == other.m_Archetype && m_Chunk == other.m_Chunk;
+        }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+        // Advances to the next row that belongs in the view (or end)
+        void Settle() {
+            if (!m_View->m_Archetypal) {
+                while (m_Index < m_View->DriverSize() &&
+                    !m_View->Contains((*m_View->m_Driver)[m_Index]))
+                    ++m_Index;
+                return;
+            }
+
+            while (m_Archetype < m_View->m_Archetypes.size()) {
+                const Archetype* archetype = m_View->m_Archetypes[m_Archetype];
+                if (m_Chunk < archetype->GetChunkCount()) {
+                    if (m_Index < archetype->GetChunk(m_Chunk).count)
+                        return;
+                    ++m_Chunk;
+                    m_Index = 0;
+                    continue;
+                }
+                ++m_Archetype;
+                m_Chunk = 0;
+                m_Index = 0;
+            }
+        }
+
+        const ComponentView* m_View;
+        size_t m_Index;
+        size_t m_Archetype;
+        size_t m_Chunk;
+    };
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const {
+        return m_Archetypal
+            ? Iterator(this, 0, m_Archetypes.size())
+            : Iterator(this, DriverSize());
+    }
+
+    // fn(Entity, Ts&...)
+    template<typename Func>
+    void ForEach(Func&& fn) const
+    {
+        if (m_Archetypal)
+        {
+            for (size_t a = 0; a < m_Archetypes.size(); ++a)
+            {
+                const Archetype* archetype = m_Archetypes[a];
+                for (size_t c = 0; c < archetype->GetChunkCount(); ++c)
+                {
+                    const ArchetypeChunk& chunk = archetype->GetChunk(c);
+                    const EntityID* ids = archetype->GetEntityIDs(chunk);
+                    auto columns = ColumnPointers(a, chunk, std::index_sequence_for<Ts...>{});
+
+                    for (uint32_t row = 0; row < chunk.count; ++row)
+                    {
+                        std::apply([&](Ts*... data) {
+                            fn(Entity{ ids[row] }, data[row]...);
+                            }, columns);
+                    }
+                }
+            }
+            return;
+        }
+
+        for (size_t i = 0; i < DriverSize(); ++i)
+        {
+            EntityID id = (*m_Driver)[i];
+            if (!Contains(id))
+                continue;
+
+            std::apply(fn, MakeRow(Entity{ id }));
+        }
+    }
+
+    // Upper bound on the number of entities this view will yield
+    size_t SizeHint() const
+    {
+        if (!m_Archetypal)
+            return DriverSize();
+
+        size_t total = 0;
+        for (const Archetype* archetype : m_Archetypes)
+            total += archetype->Size();
+        return total;
+    }
+
+private:
+    std::tuple<ComponentArray<Ts>*...> m_Arrays;
+    const std::vector<EntityID>* m_Driver = nullptr;
+
+    bool m_Archetypal = false;
+    std::vector<Archetype*> m_Archetypes;
+    std::vector<ColumnIndices> m_Columns;   // per archetype, column of each Ts
+
+    size_t DriverSize() const { return m_Driver ? m_Driver->size() : 0; }
+
+    bool Contains(EntityID id) const {
+        return std::apply([id](auto*... arrays) {
+            return (arrays->HasData(Entity{ id }) && ...);
+            }, m_Arrays);
+    }
+
+    Row MakeRow(Entity e) const {
+        return std::apply([e](auto*... arrays) {
+            return Row(e, arrays->GetData(e)...);
+            }, m_Arrays);
+    }
+
+    template<size_t... Is>
+    std::tuple<Ts*...> ColumnPointers(size_t archetype, const ArchetypeChunk& chunk, std::index_sequence<Is...>) const {
+        return std::tuple<Ts*...>(
+            static_cast<Ts*>(m_Archetypes[archetype]->GetColumnData(chunk, m_Columns[archetype][Is]))...);
+    }
+
+    Row MakeArchetypeRow(size_t archetype, size_t chunkIndex, size_t row) const {
+        const ArchetypeChunk& chunk = m_Archetypes[archetype]->GetChunk(chunkIndex);
+        Entity e{ m_Archetypes[archetype]->GetEntityIDs(chunk)[row] };
+        return std::apply([e, row](Ts*... data) {
+            return Row(e, data[row]...);
+            }, ColumnPointers(archetype, chunk, std::index_sequence_for<Ts...>{}));
+    }
+};
@@ -2,11 +2,27 @@
 #include <cstdint>
 
 
+// Packed handle: low 22 bits are the slot index, high 10 bits the
+// slot's generation, bumped every time the slot is recycled.
 using EntityID = uint32_t;
 const EntityID INVALID_ENTITY = 0xFFFFFFFF;
 
+const uint32_t ENTITY_INDEX_BITS = 22;
+const uint32_t ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+const uint32_t ENTITY_GENERATION_MASK = (1u << (32 - ENTITY_INDEX_BITS)) - 1;
+const uint32_t MAX_ENTITY_INDEX = ENTITY_INDEX_MASK - 1;   // all-ones index is reserved for INVALID_ENTITY
+
+inline uint32_t GetEntityIndex(EntityID id) { return id & ENTITY_INDEX_MASK; }
+inline uint32_t GetEntityGeneration(EntityID id) { return id >> ENTITY_INDEX_BITS; }
+inline EntityID MakeEntityID(uint32_t index, uint32_t generation) {
+    return (generation << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK);
+}
+
 //Safety wrapper
 struct Entity {
     EntityID id = INVALID_ENTITY;
     explicit operator bool() const { return id != INVALID_ENTITY; }
+
+    uint32_t Index() const { return GetEntityIndex(id); }
+    uint32_t Generation() const { return GetEntityGeneration(id); }
 };
@@ -0,0 +1,214 @@
+#include "pch.h"
+#include "EntityCommandBuffer.h"
+#include "EntityManager.h"
+#include <algorithm>
+#include <atomic>
+
+EntityCommandBuffer::EntityCommandBuffer(size_t blockBytes)
+    : m_BlockBytes(blockBytes)
+{
+    m_Blocks.push_back(std::make_unique<LinearAllocator>(m_BlockBytes));
+}
+
+EntityCommandBuffer::~EntityCommandBuffer()
+{
+    Reset();
+}
+
+DeferredEntity EntityCommandBuffer::CreateEntity()
+{
+    DeferredEntity entity{ m_CreateCount++ };
+    Record(CommandType::Create, Target::Deferred(entity), nullptr, nullptr);
+    return entity;
+}
+
+void EntityCommandBuffer::Record(CommandType type, Target target, const ComponentOps* ops, void* payload)
+{
+    Command* command = static_cast<Command*>(Allocate(sizeof(Command), alignof(Command)));
+    *command = { type, 0, target, ops, payload, nullptr };
+
+    if (m_Tail)
+        m_Tail->next = command;
+    else
+        m_Head = command;
+    m_Tail = command;
+    ++m_CommandCount;
+}
+
+void* EntityCommandBuffer::Allocate(size_t size, size_t alignment)
+{
+    for (;;)
+    {
+        // A fresh block has room for this even at the worst-case padding
+        if (m_CurrentBlock == m_Blocks.size())
+            m_Blocks.push_back(std::make_unique<LinearAllocator>(std::max(m_BlockBytes, size + alignment - 1)));
+
+        if (void* memory = m_Blocks[m_CurrentBlock]->allocate(size, alignment))
+            return memory;
+
+        ++m_CurrentBlock;   // block full (or too small), move on to the next one
+    }
+}
+
+Entity EntityCommandBuffer::ResolveTarget(const Target& target, const EntityManager& entities) const
+{
+    Entity entity = target.deferred ? Resolve(DeferredEntity{ target.id }) : Entity{ target.id };
+    return entities.IsAlive(entity) ? entity : Entity{};
+}
+
+void EntityCommandBuffer::Playback(EntityManager& entities, ComponentManager& components)
+{
+    EntityCommandBuffer* self = this;
+    PlaybackBuffers(&self, 1, entities, components, m_Scratch);
+}
+
+void EntityCommandBuffer::PlaybackBuffers(EntityCommandBuffer* const* buffers, size_t count,
+    EntityManager& entities, ComponentManager& components, PlaybackScratch& scratch)
+{
+    // One pass per buffer: creates run as they are met (a DeferredEntity can
+    // only be used after the create that returned it), other targets are
+    // resolved, and commands are bucketed: one bucket per component type in
+    // first-seen order, destroys in a final bucket. Only a handful of types
+    // show up per frame, so the linear lookup beats hashing.
+    scratch.types.clear();
+    scratch.pending.clear();
+    const ComponentOps* lastType = nullptr;
+    uint32_t lastBucket = 0;
+
+    for (size_t b = 0; b < count; ++b)
+    {
+        EntityCommandBuffer& buffer = *buffers[b];
+        buffer.m_Created.clear();
+
+        for (Command* command = buffer.m_Head; command; command = command->next)
+        {
+            if (command->type == CommandType::Create) {
+                buffer.m_Created.push_back(entities.CreateEntity());
+                continue;
+            }
+
+            command->target = Target::Live(buffer.ResolveTarget(command->target, entities));
+            scratch.pending.push_back(command);
+
+            if (command->type == CommandType::Destroy) {
+                command->bucket = UINT32_MAX;
+                continue;
+            }
+
+            if (command->ops != lastType || scratch.types.empty())
+            {
+                auto it = std::find(scratch.types.begin(), scratch.types.end(), command->ops);
+                lastBucket = static_cast<uint32_t>(it - scratch.types.begin());
+                if (it == scratch.types.end())
+                    scratch.types.push_back(command->ops);
+                lastType = command->ops;
+            }
+            command->bucket = lastBucket;
+        }
+    }
+
+    // Counting sort: stable, so recording order survives within a bucket
+    const size_t destroyBucket = scratch.types.size();
+    scratch.offsets.assign(destroyBucket + 2, 0);
+    for (Command* command : scratch.pending)
+        ++scratch.offsets[std::min<size_t>(command->bucket, destroyBucket) + 1];
+
+    for (size_t i = 1; i < scratch.offsets.size(); ++i)
+        scratch.offsets[i] += scratch.offsets[i - 1];
+
+    scratch.sorted.resize(scratch.pending.size());
+    for (Command* command : scratch.pending)
+        scratch.sorted[scratch.offsets[std::min<size_t>(command->bucket, destroyBucket)]++] = command;
+
+    for (Command* command : scratch.sorted)
+    {
+        Entity entity{ command->target.id };
+        bool alive = entity && entities.IsAlive(entity);
+
+        switch (command->type)
+        {
+        case CommandType::Add:
+            if (alive)
+                command->ops->add(components, entity, command->payload);
+            command->ops->destroy(command->payload);
+            command->payload = nullptr;
+            break;
+
+        case CommandType::Remove:
+            if (alive)
+                command->ops->remove(components, entity);
+            break;
+
+        case CommandType::Destroy:
+            if (alive)
+            {
+                components.EntityDestroyed(entity);
+                entities.DestroyEntity(entity);
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    // Every payload has been consumed, so Reset can skip its destructor walk
+    scratch.pending.clear();
+    scratch.sorted.clear();
+    for (size_t b = 0; b < count; ++b) {
+        buffers[b]->m_PendingPayloads = 0;
+        buffers[b]->Reset();
+    }
+}
+
+void EntityCommandBuffer::Reset()
+{
+    // Payloads that were never played back still need their destructors
+    for (Command* command = m_Head; command && m_PendingPayloads > 0; command = command->next)
+    {
+        if (command->type == CommandType::Add && command->payload) {
+            command->ops->destroy(command->payload);
+            --m_PendingPayloads;
+        }
+    }
+
+    for (auto& block : m_Blocks)
+        block->reset();
+
+    m_CurrentBlock = 0;
+    m_Head = nullptr;
+    m_Tail = nullptr;
+    m_CommandCount = 0;
+    m_CreateCount = 0;
+}
+
+// ------------------------------------------------------------
+// EntityCommandBufferSet
+// ------------------------------------------------------------
+EntityCommandBufferSet::EntityCommandBufferSet(size_t blockBytes)
+    : m_BlockBytes(blockBytes)
+{
+}
+
+EntityCommandBuffer& EntityCommandBufferSet::Local()
+{
+    return m_Owners.Local([this]() {
+        auto buffer = std::make_unique<EntityCommandBuffer>(m_BlockBytes);
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Buffers.push_back(buffer.get());
+        return buffer;
+    });
+}
+
+void EntityCommandBufferSet::Playback(EntityManager& entities, ComponentManager& components)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EntityCommandBuffer::PlaybackBuffers(m_Buffers.data(), m_Buffers.size(), entities, components, m_Scratch);
+}
+
+void EntityCommandBufferSet::Reset()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (EntityCommandBuffer* buffer : m_Buffers)
+        buffer->Reset();
+}
@@ -0,0 +1,201 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <thread>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include "Entity.h"
+#include "ComponentManager.h"
+#include "../Core/Memory/LinearAllocator.h"
+#include "../PerThread.h"
+
+class EntityManager;
+
+// Handle to an entity recorded with EntityCommandBuffer::CreateEntity.
+// Only meaningful to the buffer that returned it; resolved on playback.
+struct DeferredEntity {
+    uint32_t index = 0;
+};
+
+// ------------------------------------------------------------
+// EntityCommandBuffer - deferred structural changes
+//
+// Records create / destroy / add / remove while systems iterate, then
+// applies them in one pass at a sync point. Playback order:
+//   1. creates
+//   2. adds and removes, grouped by component type with a stable
+//      bucket pass (recording order is kept within a type)
+//   3. destroys
+// Commands aimed at entities that are dead by playback time are dropped.
+//
+// Commands and payloads live in LinearAllocator blocks that are reset,
+// not freed, after playback, so steady-state recording does not touch
+// the heap. Not thread-safe: use one buffer per thread
+// (see EntityCommandBufferSet).
+// ------------------------------------------------------------
+class EntityCommandBuffer
+{
+public:
+    explicit EntityCommandBuffer(size_t blockBytes = 64 * 1024);
+    ~EntityCommandBuffer();
+
+    EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+    EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+    DeferredEntity CreateEntity();
+
+    void DestroyEntity(Entity entity) { Record(CommandType::Destroy, Target::Live(entity), nullptr, nullptr); }
+    void DestroyEntity(DeferredEntity entity) { Record(CommandType::Destroy, Target::Deferred(entity), nullptr, nullptr); }
+
+    // Adds the component, or overwrites it if the entity already has one
+    template<typename T>
+    void AddComponent(Entity entity, T component) { RecordAdd(Target::Live(entity), std::move(component)); }
+
+    template<typename T>
+    void AddComponent(DeferredEntity entity, T component) { RecordAdd(Target::Deferred(entity), std::move(component)); }
+
+    // No-op on playback if the entity lacks the component
+    template<typename T>
+    void RemoveComponent(Entity entity) { Record(CommandType::Remove, Target::Live(entity), &OpsFor<T>(), nullptr); }
+
+    // Applies and clears the recorded commands
+    void Playback(EntityManager& entities, ComponentManager& components);
+
+    // Drops the recorded commands without applying them
+    void Reset();
+
+    bool IsEmpty() const { return m_Head == nullptr; }
+    size_t GetCommandCount() const { return m_CommandCount; }
+
+    // Entities created by the last playback, indexed by DeferredEntity::index
+    Entity Resolve(DeferredEntity entity) const {
+        return entity.index < m_Created.size() ? m_Created[entity.index] : Entity{};
+    }
+
+private:
+    friend class EntityCommandBufferSet;
+
+    enum class CommandType : uint8_t { Create, Add, Remove, Destroy };
+
+    struct Target {
+        EntityID id;
+        bool deferred;
+
+        static Target Live(Entity e) { return { e.id, false }; }
+        static Target Deferred(DeferredEntity e) { return { e.index, true }; }
+    };
+
+    // Type-erased component operations, one instance per component type.
+    // Its address identifies the type when playback groups commands.
+    struct ComponentOps {
+        void (*add)(ComponentManager&, Entity, void* payload);
+        void (*remove)(ComponentManager&, Entity);
+        void (*destroy)(void* payload);
+    };
+
+    struct Command {
+        CommandType type;
+        uint32_t bucket;    // playback group, assigned during playback
+        Target target;
+        const ComponentOps* ops;
+        void* payload;
+        Command* next;
+    };
+
+    template<typename T>
+    static const ComponentOps& OpsFor();
+
+    template<typename T>
+    void RecordAdd(Target target, T&& component)
+    {
+        using U = std::decay_t<T>;
+        void* payload = Allocate(sizeof(U), alignof(U));
+        new (payload) U(std::forward<T>(component));
+        ++m_PendingPayloads;
+        Record(CommandType::Add, target, &OpsFor<U>(), payload);
+    }
+
+    void Record(CommandType type, Target target, const ComponentOps* ops, void* payload);
+    void* Allocate(size_t size, size_t alignment);
+
+    // Maps a command's target to a live entity, or an invalid Entity
+    Entity ResolveTarget(const Target& target, const EntityManager& entities) const;
+
+    // Reused between playbacks so steady-state playback does not allocate
+    struct PlaybackScratch {
+        std::vector<Command*> pending;            // recording order
+        std::vector<Command*> sorted;             // grouped by bucket
+        std::vector<const ComponentOps*> types;   // bucket -> type, in first-seen order
+        std::vector<size_t> offsets;
+    };
+
+    // Shared by single-buffer and set playback
+    static void PlaybackBuffers(EntityCommandBuffer* const* buffers, size_t count,
+        EntityManager& entities, ComponentManager& components, PlaybackScratch& scratch);
+
+    size_t m_BlockBytes;
+    std::vector<std::unique_ptr<LinearAllocator>> m_Blocks;
+    size_t m_CurrentBlock = 0;
+
+    Command* m_Head = nullptr;
+    Command* m_Tail = nullptr;
+    size_t m_CommandCount = 0;
+    size_t m_PendingPayloads = 0;       // recorded adds whose payload is still alive
+    uint32_t m_CreateCount = 0;
+
+    std::vector<Entity> m_Created;      // kept between frames to avoid reallocating
+    PlaybackScratch m_Scratch;
+};
+
+template<typename T>
+const EntityCommandBuffer::ComponentOps& EntityCommandBuffer::OpsFor()
+{
+    static const ComponentOps ops = {
+        [](ComponentManager& cm, Entity e, void* payload) {
+            T& component = *static_cast<T*>(payload);
+            if (cm.HasComponent<T>(e)) {
+                cm.GetComponent<T>(e) = std::move(component);
+                cm.MarkChanged<T>(e);   // AddComponent stamps new ones itself
+            }
+            else
+                cm.AddComponent(e, component);
+        },
+        [](ComponentManager& cm, Entity e) {
+            if (cm.HasComponent<T>(e))
+                cm.RemoveComponent<T>(e);
+        },
+        [](void* payload) { static_cast<T*>(payload)->~T(); }
+    };
+    return ops;
+}
+
+// ------------------------------------------------------------
+// EntityCommandBufferSet - one command buffer per recording thread
+//
+// Local() hands each thread its own buffer (the lock is only taken the
+// first time a thread records into this set). Playback() must run at a
+// sync point when no thread is recording; it merges every buffer into
+// a single type-sorted pass.
+// ------------------------------------------------------------
+class EntityCommandBufferSet
+{
+public:
+    explicit EntityCommandBufferSet(size_t blockBytes = 64 * 1024);
+
+    EntityCommandBuffer& Local();
+
+    void Playback(EntityManager& entities, ComponentManager& components);
+    void Reset();
+
+private:
+    size_t m_BlockBytes;
+    PerThread<EntityCommandBuffer> m_Owners;
+    std::mutex m_Mutex;
+    std::vector<EntityCommandBuffer*> m_Buffers;   // same buffers, in creation order
+    EntityCommandBuffer::PlaybackScratch m_Scratch;
+};
@@ -1,45 +1,133 @@
 #include "pch.h"
 #include "EntityManager.h"
+#include <algorithm>
+#include <stdexcept>
 
-EntityManager::EntityManager(uint32_t maxEntities)
-    : m_MaxEntities(maxEntities), m_Alive(maxEntities, false)
+EntityManager::EntityManager(uint32_t initialCapacity)
 {
-    for (EntityID id = 0; id < maxEntities; ++id)
-        m_AvailableIDs.push(id);
+    assert(initialCapacity <= MAX_ENTITY_INDEX + 1 && "initialCapacity exceeds the handle index range!");
+
+    while (GetCapacity() < initialCapacity)
+        AddPage();
+    m_Living.reserve(initialCapacity);
+}
+
+void EntityManager::AddPage()
+{
+    m_Pages.push_back(std::make_unique<Slot[]>(SlotsPerPage));
+    m_AliveBits.resize(m_AliveBits.size() + SlotsPerPage / 64, 0);
+}
+
+void EntityManager::Reserve(uint32_t count)
+{
+    uint32_t needed = GetLivingCount() + count;
+    assert(needed <= MAX_ENTITY_INDEX + 1 && "Reserve exceeds the handle index range!");
+
+    while (GetCapacity() < needed)
+        AddPage();
+    m_Living.reserve(needed);
 }
 
 Entity EntityManager::CreateEntity() {
-    assert(m_LivingCount < m_MaxEntities && "Too many entities!");
-    EntityID id = m_AvailableIDs.front();
-    m_AvailableIDs.pop();
-    m_Alive[id] = true;
-    m_LivingCount++;
-    return Entity{ id };
+    uint32_t index;
+    if (m_FreeHead != NoSlot) {
+        index = m_FreeHead;
+        m_FreeHead = GetSlot(index).nextFree;
+        if (m_FreeHead == NoSlot)
+            m_FreeTail = NoSlot;
+    }
+    else {
+        // Past this the index would reach INVALID_ENTITY's and then spill
+        // into the generation bits, so refuse in release builds too
+        if (m_SlotCount > MAX_ENTITY_INDEX)
+            throw std::length_error("EntityManager: too many entities");
+        index = m_SlotCount++;
+        if (index >= GetCapacity())
+            AddPage();
+    }
+
+    Slot& slot = GetSlot(index);
+    slot.nextFree = NoSlot;
+    slot.denseIndex = static_cast<uint32_t>(m_Living.size());
+
+    Entity entity{ MakeEntityID(index, slot.generation) };
+    m_Living.push_back(entity);
+    SetAliveBit(index);
+    return entity;
 }
 
 void EntityManager::DestroyEntity(Entity entity) {
     if (!IsAlive(entity)) return;
-    m_Alive[entity.id] = false;
-    m_AvailableIDs.push(entity.id);
-    m_LivingCount--;
+
+    uint32_t index = entity.Index();
+    Slot& slot = GetSlot(index);
+
+    // Swap-remove from the living list
+    Entity last = m_Living.back();
+    m_Living[slot.denseIndex] = last;
+    GetSlot(last.Index()).denseIndex = slot.denseIndex;
+    m_Living.pop_back();
+    slot.denseIndex = NoSlot;
+    ClearAliveBit(index);
+
+    BumpGeneration(index);
+    PushFree(index);
+}
+
+void EntityManager::BumpGeneration(uint32_t index)
+{
+    // Invalidate outstanding handles. Any generation is fine: indices stop
+    // at MAX_ENTITY_INDEX, so no handle can equal INVALID_ENTITY.
+    assert(index <= MAX_ENTITY_INDEX);
+    Slot& slot = GetSlot(index);
+    slot.generation = (slot.generation + 1) & ENTITY_GENERATION_MASK;
+}
+
+void EntityManager::PushFree(uint32_t index)
+{
+    GetSlot(index).nextFree = NoSlot;
+    if (m_FreeTail != NoSlot)
+        GetSlot(m_FreeTail).nextFree = index;
+    else
+        m_FreeHead = index;
+    m_FreeTail = index;
 }
 
 bool EntityManager::IsAlive(Entity entity) const {
-    return entity.id < m_MaxEntities && m_Alive[entity.id];
+    uint32_t index = entity.Index();
+    if (index >= m_SlotCount)
+        return false;
+
+    const Slot& slot = GetSlot(index);
+    return slot.denseIndex != NoSlot && slot.generation == entity.Generation();
 }
 
 void EntityManager::Clear()
 {
-    // Reset alive flags
-    std::fill(m_Alive.begin(), m_Alive.end(), false);
-
-    // Reset available ID pool
-    std::queue<EntityID> empty;
-    std::swap(m_AvailableIDs, empty);
+    // Every slot handed out goes back on the free list, in index order.
+    // Living ones are retired the way DestroyEntity does it, so handles
+    // held across the clear (selection, follow targets) stay dead once
+    // their slots are reused. Pages are kept.
+    m_FreeHead = NoSlot;
+    m_FreeTail = NoSlot;
+    for (uint32_t index = 0; index < m_SlotCount; ++index)
+    {
+        Slot& slot = GetSlot(index);
+        if (slot.denseIndex != NoSlot) {
+            slot.denseIndex = NoSlot;
+            BumpGeneration(index);
+        }
+        PushFree(index);
+    }
 
-    for (EntityID id = 0; id < m_MaxEntities; ++id)
-        m_AvailableIDs.push(id);
+    std::fill(m_AliveBits.begin(), m_AliveBits.end(), 0);
+    m_Living.clear();
+}
 
-    // Reset count
-    m_LivingCount = 0;
-}
\ No newline at end of file
+size_t EntityManager::GetMemoryUsage() const
+{
+    return m_Pages.size() * SlotsPerPage * sizeof(Slot)
+        + m_Pages.capacity() * sizeof(std::unique_ptr<Slot[]>)
+        + m_Living.capacity() * sizeof(Entity)
+        + m_AliveBits.capacity() * sizeof(uint64_t);
+}
@@ -1,25 +1,106 @@
 #pragma once
-#include <queue>
 #include <vector>
+#include <memory>
 #include <cassert>
+#include <cstddef>
 #include "Entity.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 //Manager for creating and destroying entities
+//
+//Handles carry a generation, so a handle to a destroyed entity stays
+//dead even after its slot is recycled. Slots live in fixed-size pages
+//that are allocated on demand, free slots form an intrusive FIFO list,
+//and living entities are kept both packed in a dense list and as bits
+//in a 64-bit-word alive bitset for ordered scans.
 class EntityManager {
 public:
-    explicit EntityManager(uint32_t maxEntities = 10000);
+    static constexpr uint32_t SlotsPerPage = 4096;
+
+    // initialCapacity only pre-allocates pages; the store grows on demand
+    explicit EntityManager(uint32_t initialCapacity = 0);
 
+    // Throws std::length_error once MAX_ENTITY_INDEX + 1 slots exist and
+    // none is free
     Entity CreateEntity();
+
+    // Pre-allocates room for count more entities (bulk loads)
+    void Reserve(uint32_t count);
     void DestroyEntity(Entity entity);
 
     bool IsAlive(Entity entity) const;
 
+    // Every living entity, packed (order changes when entities are destroyed).
+    // Copy it first if you destroy entities while iterating.
+    const std::vector<Entity>& GetLivingEntities() const { return m_Living; }
+
+    // Calls fn(Entity) for every living entity in slot order, skipping a
+    // whole word of dead slots at a time. fn may destroy entities; ones
+    // created during the scan may or may not be visited.
+    template<typename Func>
+    void ForEachAlive(Func&& fn) const
+    {
+        for (size_t word = 0; word < m_AliveBits.size(); ++word)
+        {
+            uint64_t bits = m_AliveBits[word];
+            while (bits)
+            {
+                uint32_t bit = CountTrailingZeros(bits);
+                bits &= bits - 1;
+                if (!(m_AliveBits[word] & (uint64_t(1) << bit)))
+                    continue;   // destroyed by an earlier callback
+
+                uint32_t index = static_cast<uint32_t>(word * 64 + bit);
+                fn(Entity{ MakeEntityID(index, GetSlot(index).generation) });
+            }
+        }
+    }
+
+    // Drops every entity. Slots are reused, but handles from before the
+    // clear stay dead: each living slot's generation is bumped
     void Clear();
 
-    uint32_t GetMaxEntities() const { return m_MaxEntities; }
+    uint32_t GetCapacity() const { return static_cast<uint32_t>(m_Pages.size()) * SlotsPerPage; }
+    uint32_t GetLivingCount() const { return static_cast<uint32_t>(m_Living.size()); }
+
+    // Bytes held by slot pages and the living list
+    size_t GetMemoryUsage() const;
 private:
-    std::queue<EntityID> m_AvailableIDs;
-    std::vector<bool>    m_Alive;
-    uint32_t             m_MaxEntities;
-    uint32_t             m_LivingCount = 0;
+    static constexpr uint32_t NoSlot = 0xFFFFFFFF;
+
+    struct Slot {
+        uint32_t generation = 0;
+        uint32_t nextFree = NoSlot;
+        uint32_t denseIndex = NoSlot;   // position in m_Living, NoSlot when dead
+    };
+
+    static uint32_t CountTrailingZeros(uint64_t bits)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(bits));
+#endif
+    }
+
+    void SetAliveBit(uint32_t index) { m_AliveBits[index / 64] |= uint64_t(1) << (index % 64); }
+    void ClearAliveBit(uint32_t index) { m_AliveBits[index / 64] &= ~(uint64_t(1) << (index % 64)); }
+
+    Slot& GetSlot(uint32_t index) { return m_Pages[index / SlotsPerPage][index % SlotsPerPage]; }
+    const Slot& GetSlot(uint32_t index) const { return m_Pages[index / SlotsPerPage][index % SlotsPerPage]; }
+    void AddPage();
+    void BumpGeneration(uint32_t index);
+    void PushFree(uint32_t index);
+
+    std::vector<std::unique_ptr<Slot[]>> m_Pages;
+    std::vector<Entity> m_Living;
+    std::vector<uint64_t> m_AliveBits;           // bit i set while slot i is alive
+    uint32_t            m_SlotCount = 0;         // slots ever handed out (high-water mark)
+    uint32_t            m_FreeHead = NoSlot;     // oldest freed slot, reused first
+    uint32_t            m_FreeTail = NoSlot;
 };
@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+/// <summary>
+/// Bounded lock-free multi-producer / multi-consumer queue
+/// (Dmitry Vyukov's sequence-numbered ring).
+///
+/// ThreadPool uses it for tasks submitted from threads that are not
+/// workers, which cannot push to a worker's deque. Each cell carries a
+/// sequence number that says whose turn it is, so producers and
+/// consumers only contend on their own cursor.
+/// </summary>
+template<typename T>
+class InjectionQueue
+{
+public:
+    explicit InjectionQueue(size_t capacity = 65536)
+        : m_Mask(capacity - 1), m_Cells(new Cell[capacity])
+    {
+        assert(capacity >= 2 && (capacity & (capacity - 1)) == 0 && "capacity must be a power of two!");
+        for (size_t i = 0; i < capacity; ++i)
+            m_Cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    InjectionQueue(const InjectionQueue&) = delete;
+    InjectionQueue& operator=(const InjectionQueue&) = delete;
+
+    /// <summary>
+    /// Returns false when the queue is full.
+    /// </summary>
+    bool TryPush(T item)
+    {
+        size_t pos = m_EnqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;)
+        {
+            cell = &m_Cells[pos & m_Mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0)
+            {
+                if (m_EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = m_EnqueuePos.load(std::memory_order_relaxed);
+        }
+
+        cell->data = item;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// <summary>
+    /// Returns false when the queue is empty.
+    /// </summary>
+    bool TryPop(T& item)
+    {
+        size_t pos = m_DequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;)
+        {
+            cell = &m_Cells[pos & m_Mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0)
+            {
+                if (m_DequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = m_DequeuePos.load(std::memory_order_relaxed);
+        }
+
+        item = cell->data;
+        cell->sequence.store(pos + m_Mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// <summary>
+    /// Approximate item count.
+    /// </summary>
+    [[nodiscard]] size_t Size() const
+    {
+        size_t tail = m_EnqueuePos.load(std::memory_order_relaxed);
+        size_t head = m_DequeuePos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    const size_t m_Mask;
+    std::unique_ptr<Cell[]> m_Cells;
+    alignas(64) std::atomic<size_t> m_EnqueuePos{ 0 };
+    alignas(64) std::atomic<size_t> m_DequeuePos{ 0 };
+};
@@ -1,46 +1,322 @@
 #include "pch.h"
 #include "JobSystem.h"
+#include "Profiler.h"
+#include "Core/Memory/PoolAllocator.h"
 #include <thread>
+#include <algorithm>
+#include <cassert>
 
-JobSystem::JobSystem(size_t threadCount)
-    : m_Pool(threadCount - 1) {
-}   // keep one core for main thread
+// ------------------------------------------------------------
+// JobPool - per-thread supply of Job objects
+//
+// Jobs live in PoolAllocator blocks and are constructed once, when the
+// block is added; afterwards they are only handed out and returned, so
+// their generation survives recycling. The owning thread allocates and
+// frees without synchronisation. Jobs finished on other threads are
+// pushed onto a lock-free list that the owner takes back in one swap
+// when its free list runs dry.
+// ------------------------------------------------------------
+class JobPool
+{
+public:
+    static constexpr size_t JobsPerBlock = 1024;
+
+    JobPool(JobSystem& system, std::thread::id owner) : m_System(system), m_Owner(owner) { AddBlock(); }
+
+    JobSystem& GetSystem() const { return m_System; }
+
+    Job* Allocate()
+    {
+        if (Job* job = TryAllocate())
+            return job;
+
+        ReclaimRemote();
+        if (Job* job = TryAllocate())
+            return job;
+
+        AddBlock();
+        return TryAllocate();
+    }
+
+    void Free(Job* job)
+    {
+        if (std::this_thread::get_id() == m_Owner) {
+            m_Blocks[job->chunk]->deallocate(job);
+            return;
+        }
+
+        Job* head = m_RemoteFree.load(std::memory_order_relaxed);
+        do {
+            job->nextFree = head;
+        } while (!m_RemoteFree.compare_exchange_weak(head, job, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+private:
+    Job* TryAllocate()
+    {
+        for (size_t i = 0; i < m_Blocks.size(); ++i) {
+            size_t block = (m_CurrentBlock + i) % m_Blocks.size();
+            if (void* memory = m_Blocks[block]->allocate(sizeof(Job), alignof(Job))) {
+                m_CurrentBlock = block;
+                return static_cast<Job*>(memory);
+            }
+        }
+        return nullptr;
+    }
 
-JobSystem::~JobSystem() = default;
+    void ReclaimRemote()
+    {
+        Job* job = m_RemoteFree.exchange(nullptr, std::memory_order_acquire);
+        while (job) {
+            Job* next = job->nextFree;
+            m_Blocks[job->chunk]->deallocate(job);
+            job = next;
+        }
+    }
 
-Job* JobSystem::CreateJob(std::function<void()> task, Job* parent)
+    void AddBlock()
+    {
+        auto block = std::make_unique<PoolAllocator>(sizeof(Job), JobsPerBlock, alignof(Job));
+
+        // Construct every job once, then hand the memory back to the free list
+        std::vector<Job*> jobs(JobsPerBlock);
+        for (Job*& job : jobs) {
+            job = block->New<Job>();
+            job->pool = this;
+            job->chunk = static_cast<uint32_t>(m_Blocks.size());
+        }
+        for (Job* job : jobs)
+            block->deallocate(job);
+
+        m_CurrentBlock = m_Blocks.size();
+        m_Blocks.push_back(std::move(block));
+    }
+
+    JobSystem& m_System;
+    std::thread::id m_Owner;
+    std::vector<std::unique_ptr<PoolAllocator>> m_Blocks;
+    size_t m_CurrentBlock = 0;
+    std::atomic<Job*> m_RemoteFree{ nullptr };
+};
+
+static_assert(sizeof(Job) % alignof(Job) == 0, "Jobs are packed back to back in a pool block");
+
+// Fruitless help attempts before Wait goes to sleep
+static constexpr int WaitSpinRounds = 64;
+
+// JobPriority is handed to the pool as is
+static_assert(static_cast<int>(JobPriority::Frame) == static_cast<int>(ThreadPool::Priority::High)
+    && static_cast<int>(JobPriority::Normal) == static_cast<int>(ThreadPool::Priority::Normal)
+    && static_cast<int>(JobPriority::Background) == static_cast<int>(ThreadPool::Priority::Low),
+    "JobPriority must match ThreadPool::Priority");
+
+// The waiting thread is the last worker, so the pool gets one fewer
+static ThreadPool::Config WorkerPoolConfig(ThreadPool::Config config)
 {
-    Job* job = new Job();
-    job->task = std::move(task);
-    job->parent = parent;
-    if (parent) parent->remaining.fetch_add(1);
-    return job;
+    config.threadCount = config.threadCount > 1 ? config.threadCount - 1 : 1;
+    config.firstCpu += 1;
+    return config;
 }
 
-void JobSystem::Run(Job* job)
+JobSystem::JobSystem(size_t threadCount, size_t ioThreadCount)
+    : JobSystem(ThreadPool::Config{ threadCount, ThreadPool::Affinity::None, 0, "Worker" },
+                ThreadPool::Config{ ioThreadCount, ThreadPool::Affinity::None, 0, "IO" })
 {
-    m_Pool.Submit([this, job]() {
-        job->task();
-        Finish(job);
-        });
+}
+
+JobSystem::JobSystem(const ThreadPool::Config& workers, const ThreadPool::Config& io)
+    : m_Pool(WorkerPoolConfig(workers)),
+      m_IOPool(io)
+{
+    // Workers get their pools up front, so the first job a worker
+    // spawns mid-frame does not allocate
+    for (std::thread::id worker : m_Pool.GetWorkerThreadIds())
+        m_JobPools.Add(worker, std::make_unique<JobPool>(*this, worker));
+}
+
+JobSystem::~JobSystem()
+{
+    // Frame jobs queue continuations on the I/O lane and the other way
+    // round, so neither pool may empty its queues and go while the
+    // other's workers are still running. Stop intake on both (late
+    // submits then run inline), let both sets of workers finish what is
+    // queued and exit, and only then run whatever raced in behind them.
+    m_Pool.Stop();
+    m_IOPool.Stop();
+    m_Pool.Join();
+    m_IOPool.Join();
+    m_Pool.Drain();
+    m_IOPool.Drain();
+}
+
+JobPool& JobSystem::LocalPool()
+{
+    return m_JobPools.Local([this]() { return std::make_unique<JobPool>(*this, std::this_thread::get_id()); });
+}
+
+Job* JobSystem::AllocateJob()
+{
+    return LocalPool().Allocate();
+}
+
+void JobSystem::AddDependency(Job* before, Job* after)
+{
+    assert(before->continuationCount < Job::MaxContinuations && "Too many continuations on one job!");
+    before->continuations[before->continuationCount++] = after;
+    after->blockers.fetch_add(1, std::memory_order_relaxed);
+}
+
+JobHandle JobSystem::Run(Job* job, JobPriority priority)
+{
+    return Queue(job, priority, false);
+}
+
+JobHandle JobSystem::RunIO(Job* job, JobPriority priority)
+{
+    return Queue(job, priority, true);
+}
+
+JobHandle JobSystem::Queue(Job* job, JobPriority priority, bool io)
+{
+    // Read the generation before submitting: once queued, the job may
+    // finish and be recycled at any moment
+    JobHandle handle{ job, job->generation.load(std::memory_order_relaxed) };
+    job->execute = &JobSystem::Execute;
+    job->priority = priority;
+    job->io = io;
+    if (job->blockers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        Submit(job);
+    return handle;
+}
+
+void JobSystem::Submit(Job* job)
+{
+    ThreadPool& pool = job->io ? m_IOPool : m_Pool;
+    pool.Submit(job, static_cast<ThreadPool::Priority>(job->priority));
+}
+
+void JobSystem::Execute(ThreadPool::Task* task)
+{
+    Job* job = static_cast<Job*>(task);
+    PROFILE_ZONE("Job");
+
+    // Finish even if the job throws (the pool logs it), so waiters wake
+    struct Done {
+        Job* job;
+        ~Done() { job->pool->GetSystem().Finish(job); }
+    } done{ job };
+    job->invoke(job);
 }
 
 void JobSystem::Finish(Job* job)
 {
     // Decrement this jobs counter; if still > 0, not done yet
-    if (--job->remaining > 0)
+    if (job->remaining.fetch_sub(1, std::memory_order_acq_rel) > 1)
         return;
 
+    // Copy out what outlives the job before it goes back to the pool
+    Job* parent = job->parent;
+    uint32_t continuationCount = job->continuationCount;
+    Job* continuations[Job::MaxContinuations];
+    std::copy(job->continuations, job->continuations + continuationCount, continuations);
+
+    if (job->destroy)
+        job->destroy(job);
+
+    // Handles now see the job as done; after Free it may be reused.
+    // Pairs with Wait: either the sleeper sees the new generation, or
+    // we see it registered and wake it.
+    job->generation.fetch_add(1);
+    if (job->waiters.load() > 0)
+        job->generation.notify_all();
+    job->pool->Free(job);
+
+    // The last predecessor to complete queues the continuation
+    for (uint32_t i = 0; i < continuationCount; ++i)
+        if (continuations[i]->blockers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            Submit(continuations[i]);
+
     // If this job has a parent, mark the parent as one step closer to completion
-    if (job->parent)
-        Finish(job->parent);
+    if (parent)
+        Finish(parent);
+}
+
+void JobSystem::Wait(JobHandle handle)
+{
+    int idleRounds = 0;
+    while (!handle.IsDone())
+    {
+        // Help: the queued jobs are often the very ones we wait for
+        if (m_Pool.TryRunOne()) {
+            idleRounds = 0;
+            continue;
+        }
+
+        if (++idleRounds < WaitSpinRounds) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Nothing to help with: the job is running elsewhere, so sleep
+        // until Finish bumps its generation. Jobs queued meanwhile are
+        // left to the workers.
+        Job* job = handle.job;
+        job->waiters.fetch_add(1);
+        job->generation.wait(handle.generation);
+        job->waiters.fetch_sub(1);
+        idleRounds = 0;
+    }
+}
 
-    // Delete the job now that its done
-    delete job;
+size_t JobSystem::AutoGrainSize(size_t count) const
+{
+    // About four chunks per thread (workers plus the caller) leaves room
+    // for stealing to even out uneven chunks without drowning in tasks
+    size_t chunks = (m_Pool.GetThreadCount() + 1) * 4;
+    return count / chunks + 1;
+}
+
+void JobSystem::ParallelFor(size_t begin, size_t end, RangeTask& task)
+{
+    if (begin >= end)
+        return;
+
+    auto waitForHalves = [this, &task]() {
+        while (task.pending.load(std::memory_order_acquire) > 0)
+            if (!m_Pool.TryRunOne())
+                std::this_thread::yield();
+    };
+
+    // The submitted halves reference task, so never leave before they finish
+    try
+    {
+        SplitRange(begin, end, task);
+    }
+    catch (...)
+    {
+        waitForHalves();
+        throw;
+    }
+    waitForHalves();
 }
 
-void JobSystem::Wait(Job* job)
+void JobSystem::SplitRange(size_t begin, size_t end, RangeTask& task)
 {
-    while (job->remaining > 0)
-        std::this_thread::yield(); // light spin-wait
+    while (end - begin > task.grainSize)
+    {
+        size_t mid = begin + (end - begin) / 2;
+        task.pending.fetch_add(1, std::memory_order_relaxed);
+        // Frame priority: someone is already blocked on the whole range
+        Run(CreateJob([this, &task, mid, end]() {
+            // Count the half as done even if fn throws (the pool logs it)
+            struct Done {
+                RangeTask& task;
+                ~Done() { task.pending.fetch_sub(1, std::memory_order_release); }
+            } done{ task };
+            SplitRange(mid, end, task);
+            }), JobPriority::Frame);
+        end = mid;
+    }
+
+    task.invoke(task.fn, begin, end);
 }
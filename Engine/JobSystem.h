@@ -1,27 +1,188 @@
 #pragma once
 #include <functional>
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
 #include "ThreadPool.h"
+#include "PerThread.h"
 #include <vector>
 
-struct Job {
-    std::function<void()> task;   // the actual work
-    std::atomic<int> remaining{ 1 }; // refcount/dependency counter
-    Job* parent = nullptr;         // optional parent (for dependency trees)
+class JobPool;
+
+// Which queued jobs the workers pick up first. A running job is never
+// preempted, so long or blocking work belongs on the I/O lane (RunIO),
+// not at Background priority on the frame workers.
+enum class JobPriority : uint8_t {
+    Frame,        // the current frame waits on it: systems, ParallelFor
+    Normal,
+    Background,   // may take several frames
+};
+
+// Jobs come from per-thread pools and are recycled as soon as they
+// finish, so a Job* must not be touched after Run; keep the JobHandle.
+// Callables up to CaptureSize bytes are stored inline in the job;
+// larger ones fall back to one heap allocation.
+//
+// Two ways to order work:
+//  - parent: the parent does not complete until its children have
+//    (fork/join; the parent may run before them)
+//  - AddDependency(before, after): after does not start until before
+//    has completed; a job may have any number of predecessors and up to
+//    MaxContinuations successors
+struct Job : ThreadPool::Task {     // Task::execute doubles as the pool's free-list link
+    static constexpr size_t CaptureSize = 64;
+    static constexpr size_t MaxContinuations = 8;
+
+    void (*invoke)(Job*) = nullptr;        // runs the callable in capture
+    void (*destroy)(Job*) = nullptr;       // destroys it, nullptr if trivial
+    std::atomic<int> remaining{ 1 };       // refcount/dependency counter
+    std::atomic<uint32_t> generation{ 0 }; // bumped every time the job is recycled
+    std::atomic<uint32_t> waiters{ 0 };    // threads asleep in Wait on this job
+    Job* parent = nullptr;                 // optional parent (for dependency trees)
+    std::atomic<int> blockers{ 1 };        // unfinished predecessors, +1 until Run
+    uint32_t continuationCount = 0;
+    JobPriority priority = JobPriority::Normal; // set by Run / RunIO
+    bool io = false;                       // queued on the I/O workers
+    Job* continuations[MaxContinuations];  // queued once this job completes
+    JobPool* pool = nullptr;               // pool the job returns to
+    uint32_t chunk = 0;                    // block inside that pool
+    Job* nextFree = nullptr;               // link while queued for a cross-thread free
+    alignas(std::max_align_t) unsigned char capture[CaptureSize];
+};
+
+// Refers to one use of a pooled Job; stays valid (and reports done)
+// after the job has been recycled, for as long as the JobSystem lives
+struct JobHandle {
+    Job* job = nullptr;
+    uint32_t generation = 0;
+
+    bool IsDone() const {
+        return !job || job->generation.load(std::memory_order_acquire) != generation;
+    }
 };
 
 class JobSystem {
 public:
-    explicit JobSystem(size_t threadCount = std::thread::hardware_concurrency());
+    // Starts threadCount - 1 workers: the thread that waits on jobs
+    // (usually the main thread) makes up the last one by helping in Wait.
+    // ioThreadCount more threads form the I/O lane; they mostly sleep
+    // in blocking calls, so they are not counted against the cores.
+    explicit JobSystem(size_t threadCount = std::thread::hardware_concurrency(), size_t ioThreadCount = 2);
+
+    // Same, with affinity and names: workers.threadCount counts the
+    // waiting thread too, and pinned workers start one CPU after
+    // workers.firstCpu, leaving that one to the waiting thread
+    JobSystem(const ThreadPool::Config& workers, const ThreadPool::Config& io);
     ~JobSystem();
 
-    Job* CreateJob(std::function<void()> task, Job* parent = nullptr);
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Takes a job from the calling thread's pool; no heap allocation
+    // once the pool is warm and the callable fits the capture buffer
+    template<typename Func>
+    Job* CreateJob(Func&& task, Job* parent = nullptr)
+    {
+        using F = std::decay_t<Func>;
+        Job* job = AllocateJob();
+
+        if constexpr (sizeof(F) <= Job::CaptureSize && alignof(F) <= alignof(std::max_align_t)) {
+            new (job->capture) F(std::forward<Func>(task));
+            job->invoke = [](Job* j) { (*std::launder(reinterpret_cast<F*>(j->capture)))(); };
+            if constexpr (std::is_trivially_destructible_v<F>)
+                job->destroy = nullptr;
+            else
+                job->destroy = [](Job* j) { std::launder(reinterpret_cast<F*>(j->capture))->~F(); };
+        }
+        else {
+            new (job->capture) F*(new F(std::forward<Func>(task)));
+            job->invoke = [](Job* j) { (**std::launder(reinterpret_cast<F**>(j->capture)))(); };
+            job->destroy = [](Job* j) { delete *std::launder(reinterpret_cast<F**>(j->capture)); };
+        }
+
+        job->remaining.store(1, std::memory_order_relaxed);
+        job->blockers.store(1, std::memory_order_relaxed);
+        job->continuationCount = 0;
+        job->parent = parent;
+        if (parent) parent->remaining.fetch_add(1);
+        return job;
+    }
 
-    void Run(Job* job);           // submits to thread pool
-    void Wait(Job* job);          // blocks until finished
+    // after will not start until before has completed (including its
+    // children). Call before either job is Run.
+    void AddDependency(Job* before, Job* after);
+
+    // Submits to the thread pool; a job with unfinished predecessors is
+    // queued by the last of them to complete
+    JobHandle Run(Job* job, JobPriority priority = JobPriority::Normal);
+
+    // Like Run, but on the I/O lane: a small, fixed group of threads for
+    // jobs that block (file reads, simulated loads). However many are
+    // queued, at most ioThreadCount run at once, and never on a thread
+    // that frame jobs need. Wait does not help with I/O jobs.
+    JobHandle RunIO(Job* job, JobPriority priority = JobPriority::Normal);
+
+    // Runs queued jobs on the calling thread until the job is done; if
+    // there is nothing to help with for a while, sleeps until it is
+    void Wait(JobHandle handle);
+
+    // Calls fn(chunkBegin, chunkEnd) over [begin, end) split into chunks
+    // of at most grainSize elements, and returns when all have run.
+    // The range is halved recursively: each split hands its upper half
+    // to the pool and keeps the lower one, so idle workers steal the
+    // largest pieces first. The calling thread runs a chunk too.
+    // grainSize 0 picks one that gives every thread a few chunks.
+    // While waiting the caller runs other queued jobs, so it is safe to
+    // call from inside a job.
+    template<typename Func>
+    void ParallelFor(size_t begin, size_t end, size_t grainSize, Func&& fn)
+    {
+        using F = std::remove_reference_t<Func>;
+        RangeTask task;
+        task.fn = const_cast<void*>(static_cast<const void*>(&fn));
+        task.invoke = [](void* f, size_t first, size_t last) { (*static_cast<F*>(f))(first, last); };
+        task.grainSize = grainSize ? grainSize : AutoGrainSize(end > begin ? end - begin : 0);
+        ParallelFor(begin, end, task);
+    }
+
+    [[nodiscard]] size_t GetThreadCount() const noexcept { return m_Pool.GetThreadCount(); }
+    [[nodiscard]] size_t GetIOThreadCount() const noexcept { return m_IOPool.GetThreadCount(); }
+
+    // Frame-end instrumentation of the frame workers; the last stats
+    // entry covers threads helping in Wait (see ThreadPool)
+    void CollectStats(std::vector<ThreadPool::WorkerStats>& out) { m_Pool.CollectStats(out); }
+    void SetTracing(bool enabled) { m_Pool.SetTracing(enabled); }
+    void CollectTrace(std::vector<ThreadPool::TraceEvent>& out) { m_Pool.CollectTrace(out); }
 
 private:
+    // ~JobSystem shuts both pools down itself; declared first so the
+    // job pools are still there while that runs
+    PerThread<JobPool> m_JobPools;   // one per thread that created jobs
+
     ThreadPool m_Pool;
+    ThreadPool m_IOPool;
+
+    // Type-erased ParallelFor state, lives on the caller's stack
+    struct RangeTask {
+        void (*invoke)(void* fn, size_t first, size_t last) = nullptr;
+        void* fn = nullptr;
+        size_t grainSize = 1;
+        std::atomic<size_t> pending{ 0 };   // submitted halves not yet finished
+    };
+
+    void ParallelFor(size_t begin, size_t end, RangeTask& task);
+    void SplitRange(size_t begin, size_t end, RangeTask& task);
+    size_t AutoGrainSize(size_t count) const;
+
+    Job* AllocateJob();
+    JobPool& LocalPool();
 
+    JobHandle Queue(Job* job, JobPriority priority, bool io);
+    void Submit(Job* job);
+    static void Execute(ThreadPool::Task* task);
     void Finish(Job* job);
 };
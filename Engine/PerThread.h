@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+/// <summary>
+/// One T per thread that uses the owning object, kept until the owner
+/// goes away.
+///
+/// Local() finds the calling thread's entry under a lock the first time,
+/// then remembers it in a thread_local cache, so later calls cost one
+/// compare. The cache is keyed by a serial number taken at construction
+/// rather than by address: an owner destroyed and rebuilt at the same
+/// address must not hand out the old owner's entry. Each thread caches
+/// one owner per T; switching between owners falls back to the lookup.
+/// </summary>
+template<typename T>
+class PerThread
+{
+public:
+    PerThread() : m_Serial(s_NextSerial.fetch_add(1, std::memory_order_relaxed)) {}
+
+    PerThread(const PerThread&) = delete;
+    PerThread& operator=(const PerThread&) = delete;
+
+    /// <summary>
+    /// The calling thread's entry. On its first call a thread gets
+    /// create(), which returns a std::unique_ptr<T> and runs under the
+    /// lock.
+    /// </summary>
+    template<typename Create>
+    T& Local(Create&& create)
+    {
+        if (t_Cache.serial == m_Serial)
+            return *t_Cache.entry;
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        std::thread::id self = std::this_thread::get_id();
+
+        T* entry = nullptr;
+        for (auto& [owner, owned] : m_Entries)
+        {
+            if (owner == self) {
+                entry = owned.get();
+                break;
+            }
+        }
+
+        if (!entry)
+        {
+            m_Entries.emplace_back(self, create());
+            entry = m_Entries.back().second.get();
+        }
+
+        t_Cache = { m_Serial, entry };
+        return *entry;
+    }
+
+    /// <summary>
+    /// Makes the entry for another thread ahead of its first Local().
+    /// </summary>
+    T& Add(std::thread::id owner, std::unique_ptr<T> entry)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Entries.emplace_back(owner, std::move(entry));
+        return *m_Entries.back().second;
+    }
+
+    /// <summary>
+    /// Calls fn(T&) for every entry in creation order, holding the lock.
+    /// </summary>
+    template<typename Fn>
+    void ForEach(Fn&& fn) const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (auto& entry : m_Entries)
+            fn(*entry.second);
+    }
+
+private:
+    struct LocalCache {
+        uint64_t serial = 0;
+        T* entry = nullptr;
+    };
+
+    static inline std::atomic<uint64_t> s_NextSerial{ 1 };
+    static inline thread_local LocalCache t_Cache;
+
+    uint64_t m_Serial;
+    mutable std::mutex m_Mutex;
+    std::vector<std::pair<std::thread::id, std::unique_ptr<T>>> m_Entries;
+};
@@ -30,25 +30,10 @@ void PhysicsSystem::Update(
     float dt
 )
 {
-    const uint32_t maxEntities = entities.GetMaxEntities();
+    auto colliders = comps.View<ColliderComponent, TransformComponent>();
 
-    for (uint32_t id = 0; id < maxEntities; ++id)
+    for (auto [e, physics, transform] : comps.View<PhysicsComponent, TransformComponent>())
     {
-        Entity e{ id };
-
-        if (!entities.IsAlive(e))
-            continue;
-
-        if (!comps.HasComponent<PhysicsComponent>(e) ||
-            !comps.HasComponent<TransformComponent>(e))
-            continue;
-
-        auto& physics =
-            comps.GetComponent<PhysicsComponent>(e);
-
-        auto& transform =
-            comps.GetComponent<TransformComponent>(e);
-
         if (!physics.enabled)
             continue;
 
@@ -61,6 +46,10 @@ void PhysicsSystem::Update(
         // ------------------------------------------------------------
         // INTEGRATE VELOCITY
         // ------------------------------------------------------------
+        const float startX = transform.position.x;
+        const float startY = transform.position.y;
+        const float startZ = transform.position.z;
+
         transform.position.x += physics.velocity.x * dt;
         transform.position.y += physics.velocity.y * dt;
         transform.position.z += physics.velocity.z * dt;
@@ -79,6 +68,12 @@ void PhysicsSystem::Update(
             physics.grounded = false;
         }
 
+        // Resting bodies stay out of change-tracking queries
+        if (transform.position.x != startX ||
+            transform.position.y != startY ||
+            transform.position.z != startZ)
+            comps.MarkChanged<TransformComponent>(e);
+
         // ------------------------------------------------------------
         // COLLISIONS
         // ------------------------------------------------------------
@@ -91,29 +86,14 @@ void PhysicsSystem::Update(
         if (colA.isStatic)
             continue;
 
-        for (uint32_t otherID = 0; otherID < maxEntities; ++otherID)
+        for (auto [other, colB, otherTransform] : colliders)
         {
-            if (otherID == id)
+            if (other.id == e.id)
                 continue;
 
-            Entity other{ otherID };
-
-            if (!entities.IsAlive(other))
-                continue;
-
-            if (!comps.HasComponent<ColliderComponent>(other) ||
-                !comps.HasComponent<TransformComponent>(other))
-                continue;
-
-            auto& colB =
-                comps.GetComponent<ColliderComponent>(other);
-
-            if (!colB.isStatic && otherID < id)
+            if (!colB.isStatic && other.id < e.id)
                 continue;
 
-            auto& otherTransform =
-                comps.GetComponent<TransformComponent>(other);
-
             if (!AABBOverlap(
                 transform.position, colA.halfExtents,
                 otherTransform.position, colB.halfExtents))
@@ -150,6 +130,8 @@ void PhysicsSystem::Update(
                 transform.position.z += (dz < 0.0f ? -pz : pz);
                 physics.velocity.z = 0.0f;
             }
+
+            comps.MarkChanged<TransformComponent>(e);
         }
     }
 }
\ No newline at end of file
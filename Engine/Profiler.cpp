@@ -0,0 +1,168 @@
+#include "pch.h"
+#include "Profiler.h"
+#include "TraceRing.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+std::atomic<bool> Profiler::s_Enabled{ false };
+
+namespace
+{
+    struct ZoneRecord
+    {
+        const char* name;
+        uint64_t beginNs;
+        uint64_t endNs;
+    };
+
+    // One thread's zones
+    struct ZoneBuffer
+    {
+        explicit ZoneBuffer(uint32_t id) : thread(id) {}
+
+        TraceRing<ZoneRecord, Profiler::ZoneCapacity> ring;
+        uint64_t cleared = 0;              // zones before this were dropped by Clear
+        std::string name;
+        uint32_t thread;
+    };
+
+    // Buffers live until exit, so a thread that has finished still shows
+    // up in the next trace
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ZoneBuffer>> buffers;
+    };
+
+    Registry& GetRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    thread_local ZoneBuffer* t_Buffer = nullptr;
+    thread_local std::string t_ThreadName;
+
+    ZoneBuffer& LocalBuffer()
+    {
+        if (t_Buffer)
+            return *t_Buffer;
+
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.buffers.push_back(std::make_unique<ZoneBuffer>(static_cast<uint32_t>(registry.buffers.size())));
+        t_Buffer = registry.buffers.back().get();
+        t_Buffer->name = t_ThreadName.empty() ? "Thread " + std::to_string(t_Buffer->thread) : t_ThreadName;
+        return *t_Buffer;
+    }
+
+    void WriteEscaped(std::ostream& out, const char* text)
+    {
+        for (; *text; ++text)
+        {
+            char c = *text;
+            if (c == '"' || c == '\\')
+                out << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20)
+                out << ' ';
+            else
+                out << c;
+        }
+    }
+}
+
+uint64_t Profiler::NowNs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Profiler::SetThreadName(const std::string& name)
+{
+    t_ThreadName = name;
+    if (t_Buffer)
+    {
+        std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+        t_Buffer->name = name;
+    }
+}
+
+void Profiler::Record(const char* name, uint64_t beginNs, uint64_t endNs)
+{
+    LocalBuffer().ring.Push({ name, beginNs, endNs });
+}
+
+void Profiler::Clear()
+{
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto& buffer : registry.buffers)
+        buffer->cleared = buffer->ring.Head();
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path)
+{
+    struct Zone {
+        const char* name;
+        uint64_t beginNs;
+        uint64_t endNs;
+        uint32_t thread;
+    };
+
+    std::vector<Zone> zones;
+    std::vector<std::pair<uint32_t, std::string>> threads;
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto& buffer : registry.buffers)
+        {
+            uint32_t thread = buffer->thread;
+            buffer->ring.ReadSince(buffer->cleared, zones, [thread](const ZoneRecord& record) {
+                return Zone{ record.name, record.beginNs, record.endNs, thread };
+            });
+
+            threads.emplace_back(buffer->thread, buffer->name);
+        }
+    }
+
+    std::ofstream file(path);
+    if (!file)
+        return false;
+
+    // Timestamps in microseconds from the earliest zone
+    uint64_t originNs = std::numeric_limits<uint64_t>::max();
+    for (const Zone& zone : zones)
+        originNs = std::min(originNs, zone.beginNs);
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << std::fixed << std::setprecision(3);
+
+    bool first = true;
+    for (const auto& [thread, name] : threads)
+    {
+        file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread
+            << ",\"args\":{\"name\":\"";
+        WriteEscaped(file, name.c_str());
+        file << "\"}}";
+        first = false;
+    }
+
+    for (const Zone& zone : zones)
+    {
+        file << (first ? "" : ",\n") << "{\"name\":\"";
+        WriteEscaped(file, zone.name ? zone.name : "?");
+        file << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" << zone.thread
+            << ",\"ts\":" << (zone.beginNs - originNs) / 1000.0
+            << ",\"dur\":" << (zone.endNs - zone.beginNs) / 1000.0 << "}";
+        first = false;
+    }
+
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <string>
+#include <cstdint>
+
+// ------------------------------------------------------------
+// Profiler - scoped CPU zones, exported as a Chrome trace
+//
+//   PROFILE_ZONE("Physics");    // times the enclosing scope
+//
+// While zones are enabled (SetEnabled), each one records its name and
+// begin/end time into a ring owned by the calling thread, keeping the
+// most recent ZoneCapacity zones per thread. WriteChromeTrace dumps the
+// rings as JSON for chrome://tracing or ui.perfetto.dev, one row per
+// thread. Nesting shows up from the timestamps.
+//
+// Disabled at runtime, a zone costs one relaxed load. Build with
+// ENGINE_PROFILER=0 to compile zones out altogether.
+//
+// Zone names are stored as pointers, so they must stay valid until the
+// trace has been written: string literals, or strings owned by
+// something that outlives the capture.
+// ------------------------------------------------------------
+#ifndef ENGINE_PROFILER
+#define ENGINE_PROFILER 1
+#endif
+
+class Profiler
+{
+public:
+    static constexpr size_t ZoneCapacity = 65536;   // zones kept per thread
+
+    static void SetEnabled(bool enabled) { s_Enabled.store(enabled, std::memory_order_relaxed); }
+    static bool IsEnabled() { return s_Enabled.load(std::memory_order_relaxed); }
+
+    // Row label for the calling thread in the trace
+    static void SetThreadName(const std::string& name);
+
+    // Writes every zone still held by the rings; may run while other
+    // threads keep recording. False if the file cannot be written.
+    static bool WriteChromeTrace(const std::string& path);
+
+    // Drops everything recorded so far
+    static void Clear();
+
+    static uint64_t NowNs();
+
+    class Scope
+    {
+    public:
+        explicit Scope(const char* name)
+        {
+            if (IsEnabled()) {
+                m_Name = name;
+                m_BeginNs = NowNs();
+            }
+        }
+
+        ~Scope()
+        {
+            if (m_Name)
+                Record(m_Name, m_BeginNs, NowNs());
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* m_Name = nullptr;
+        uint64_t m_BeginNs = 0;
+    };
+
+private:
+    static void Record(const char* name, uint64_t beginNs, uint64_t endNs);
+
+    static std::atomic<bool> s_Enabled;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if ENGINE_PROFILER
+#define PROFILE_ZONE(name) Profiler::Scope PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#endif
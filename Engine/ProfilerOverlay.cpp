@@ -1,10 +1,36 @@
 #include "pch.h"
 #include "ProfilerOverlay.h"
+#include <algorithm>
 
 ProfilerOverlay::ProfilerOverlay(Allocator* allocator)
     : m_Allocator(allocator), m_FrameCount(0), m_AccumTime(0.0f) {
 }
 
+void ProfilerOverlay::recordJobs(const std::vector<ThreadPool::WorkerStats>& stats,
+                                 const std::vector<ThreadPool::TraceEvent>& trace) {
+    m_JobThreads = stats.size();
+    for (const auto& worker : stats) {
+        m_JobsExecuted += worker.tasksExecuted;
+        m_Steals += worker.steals;
+        m_IdleNs += worker.idleNs;
+        m_QueueHighWater = std::max(m_QueueHighWater, worker.queueHighWater);
+    }
+    for (const auto& event : trace)
+        m_LongestJobNs = std::max(m_LongestJobNs, event.endNs - event.beginNs);
+}
+
+void ProfilerOverlay::recordFrameMemory(uint64_t heapAllocations, const FrameArena::Stats& arena) {
+    m_HeapAllocations += heapAllocations;
+    m_MaxFrameHeapAllocations = std::max(m_MaxFrameHeapAllocations, heapAllocations);
+    m_ArenaPeakBytes = std::max(m_ArenaPeakBytes, arena.usedBytes);
+    m_Arena = arena;
+}
+
+void ProfilerOverlay::recordLuaMemory(const LuaAllocator& lua) {
+    m_Lua = &lua;
+    m_LuaPeakBytes = std::max(m_LuaPeakBytes, lua.GetStats().liveBytes);
+}
+
 void ProfilerOverlay::update(float frameTimeMs) {
     m_FrameCount++;
     m_AccumTime += frameTimeMs;
@@ -19,11 +45,47 @@ void ProfilerOverlay::update(float frameTimeMs) {
             << " | Frame Time: " << (m_AccumTime / m_FrameCount) << " ms\n";
         std::cout << "Allocator Stats: total=" << stats.totalAllocated
             << " bytes, peak=" << stats.peakUsage
+            << " bytes, padding=" << stats.paddingBytes
             << " bytes, allocations=" << stats.allocationCount << "\n";
+        std::cout << "Heap: " << m_HeapAllocations / m_FrameCount << " allocs/frame"
+            << " (max " << m_MaxFrameHeapAllocations << ")"
+            << " | Frame arena: peak " << m_ArenaPeakBytes / 1024.0 << " KB/frame"
+            << ", reserved " << m_Arena.reservedBytes / 1024 << " KB"
+            << " on " << m_Arena.threads << " threads\n";
+        if (m_Lua) {
+            LuaAllocator::Stats lua = m_Lua->GetStats();
+            const auto& scripts = m_Lua->GetScriptStats();
+            m_LuaBytesAtReport.resize(scripts.size(), 0);
+
+            std::cout << "Lua: live " << lua.liveBytes / 1024 << " KB (peak " << m_LuaPeakBytes / 1024 << " KB)"
+                << ", slabs " << lua.slabBytes / 1024 << " KB in " << lua.mappedBytes / 1024 << " KB mapped"
+                << ", large " << lua.largeBytes / 1024 << " KB\n";
+            for (size_t i = 0; i < scripts.size(); ++i) {
+                uint64_t bytes = scripts[i].allocatedBytes - m_LuaBytesAtReport[i];
+                m_LuaBytesAtReport[i] = scripts[i].allocatedBytes;
+                if (bytes)
+                    std::cout << "  " << scripts[i].path << ": " << bytes / m_FrameCount / 1024.0 << " KB/frame allocated\n";
+            }
+        }
+        if (m_JobThreads > 1) {
+            // Idle share of the workers' time (the last entry is helpers, not a worker)
+            double workerNs = (m_JobThreads - 1) * m_AccumTime * 1.0e6;
+            std::cout << "Jobs: executed=" << m_JobsExecuted
+                << ", steals=" << m_Steals
+                << ", worker idle=" << (workerNs > 0 ? 100.0 * m_IdleNs / workerNs : 0.0) << "%"
+                << ", max queue=" << m_QueueHighWater;
+            if (m_LongestJobNs)
+                std::cout << ", longest job=" << m_LongestJobNs / 1000.0 << " us";
+            std::cout << "\n";
+        }
         std::cout << "==========================\n";
 
         // reset counters
         m_FrameCount = 0;
         m_AccumTime = 0.0f;
+        m_JobsExecuted = m_Steals = m_IdleNs = m_QueueHighWater = m_LongestJobNs = 0;
+        m_HeapAllocations = m_MaxFrameHeapAllocations = 0;
+        m_ArenaPeakBytes = 0;
+        m_LuaPeakBytes = 0;
     }
 }
@@ -2,12 +2,28 @@
 #include "pch.h"
 #include <iostream>
 #include <chrono>
+#include <vector>
 #include "../Engine/Core/Memory/Allocator.h"
+#include "../Engine/ThreadPool.h"
+#include "../Engine/Core/Memory/FrameArena.h"
+#include "../Engine/Scripting/LuaAllocator.h"
 
 class ProfilerOverlay {
 public:
     explicit ProfilerOverlay(Allocator* allocator);
 
+    // Called at frame end with the job system's counters and, if
+    // tracing is on, its task timestamps for the frame
+    void recordJobs(const std::vector<ThreadPool::WorkerStats>& stats,
+                    const std::vector<ThreadPool::TraceEvent>& trace);
+
+    // Called at frame end with the heap allocations made during the
+    // frame and the frame arena's usage
+    void recordFrameMemory(uint64_t heapAllocations, const FrameArena::Stats& arena);
+
+    // Called at frame end with the script system's Lua allocator
+    void recordLuaMemory(const LuaAllocator& lua);
+
     // Called every frame with frame time (ms)
     void update(float frameTimeMs);
 
@@ -15,4 +31,24 @@ private:
     Allocator* m_Allocator;
     int m_FrameCount;
     float m_AccumTime; // accumulate until 1s has passed
+
+    // Job system totals over the same second
+    uint64_t m_JobsExecuted = 0;
+    uint64_t m_Steals = 0;
+    uint64_t m_IdleNs = 0;
+    uint64_t m_QueueHighWater = 0;
+    uint64_t m_LongestJobNs = 0;
+    size_t m_JobThreads = 0;
+
+    // Per-frame memory over the same second
+    uint64_t m_HeapAllocations = 0;
+    uint64_t m_MaxFrameHeapAllocations = 0;
+    size_t m_ArenaPeakBytes = 0;
+    FrameArena::Stats m_Arena;
+
+    // Lua: the allocator, and each script's allocated bytes when the
+    // second started, to report what they allocated since
+    const LuaAllocator* m_Lua = nullptr;
+    size_t m_LuaPeakBytes = 0;
+    std::vector<uint64_t> m_LuaBytesAtReport;
 };
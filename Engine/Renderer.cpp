@@ -3,6 +3,8 @@
 #include <vector>
 #include <iostream>
 #include "Math/MathConversions.h"
+#include "Profiler.h"
+#include <cassert>
 
 // Cube data
 static const float cubeVerts[] = {
@@ -143,8 +145,8 @@ void Renderer::RenderToTexture(const EntityManager& entities,
     int height,
     Entity selectedEntity)
 {
+    PROFILE_ZONE("Renderer");
 
-  
     EnsureFramebufferSize(width, height);
     glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
     glViewport(0, 0, width, height);
@@ -165,49 +167,55 @@ void Renderer::RenderToTexture(const EntityManager& entities,
         glBindVertexArray(vao);
     }
 
-    //  Loop through entities and draw their transforms
-    for (uint32_t id = 0; id < 10000; ++id)
+    // Same for every entity
+    glm::mat4 view = glm::lookAt(cam.position, cam.position + cam.forward, cam.up);
+    glm::mat4 proj = glm::perspective(glm::radians(cam.fov), cam.aspect, cam.nearPlane, cam.farPlane);
+    glm::mat4 viewProj = proj * view;
+
+    //  Gather this frame's draw list in scratch memory, then draw it
+    struct DrawItem {
+        glm::mat4 mvp;
+        glm::vec3 color;
+    };
+    assert(m_FrameArena && "SetFrameArena before rendering!");
+    const std::vector<Entity>& living = entities.GetLivingEntities();
+    std::span<DrawItem> drawList = m_FrameArena->AllocateArray<DrawItem>(living.size());
+    size_t drawCount = 0;
+
+    for (Entity e : living)
     {
-        Entity e{ id };
-        if (!entities.IsAlive(e)) continue;
-
         // Only draw entities that actually have a TransformComponent
-        try {
-            auto& t = comps.GetComponent<TransformComponent>(e);
+        if (!comps.HasComponent<TransformComponent>(e))
+            continue;
 
-            glm::vec3 color = (e.id == selectedEntity.id)
-                ? glm::vec3(1.0f, 0.5f, 0.0f)  // orange highlight
-                : glm::vec3(0.4f, 0.8f, 0.6f);
+        auto& t = comps.GetComponent<TransformComponent>(e);
 
-            // Build model matrix manually using TransformComponent fields
-            glm::mat4 model = glm::mat4(1.0f);
+        glm::vec3 color = (e.id == selectedEntity.id)
+            ? glm::vec3(1.0f, 0.5f, 0.0f)  // orange highlight
+            : glm::vec3(0.4f, 0.8f, 0.6f);
 
-            // Apply translation
-            model = glm::translate(model, glm::vec3(t.position.x, t.position.y, t.position.z));
+        // Build model matrix manually using TransformComponent fields
+        glm::mat4 model = glm::mat4(1.0f);
 
-            // Apply rotation (convert degrees to radians)
-            model = glm::rotate(model, glm::radians(t.rotation.x), glm::vec3(1, 0, 0));
-            model = glm::rotate(model, glm::radians(t.rotation.y), glm::vec3(0, 1, 0));
-            model = glm::rotate(model, glm::radians(t.rotation.z), glm::vec3(0, 0, 1));
+        // Apply translation
+        model = glm::translate(model, glm::vec3(t.position.x, t.position.y, t.position.z));
 
-            // Apply scale
-            model = glm::scale(model, glm::vec3(t.scale.x, t.scale.y, t.scale.z));
+        // Apply rotation (convert degrees to radians)
+        model = glm::rotate(model, glm::radians(t.rotation.x), glm::vec3(1, 0, 0));
+        model = glm::rotate(model, glm::radians(t.rotation.y), glm::vec3(0, 1, 0));
+        model = glm::rotate(model, glm::radians(t.rotation.z), glm::vec3(0, 0, 1));
 
-            // View + Projection as before
-            glm::mat4 view = glm::lookAt(cam.position, cam.position + cam.forward, cam.up);
-            glm::mat4 proj = glm::perspective(glm::radians(cam.fov), cam.aspect, cam.nearPlane, cam.farPlane);
+        // Apply scale
+        model = glm::scale(model, glm::vec3(t.scale.x, t.scale.y, t.scale.z));
 
-            // Combine them
-            glm::mat4 mvp = proj * view * model;
-            glUniformMatrix4fv(mvpLoc, 1, GL_FALSE, &mvp[0][0]);
+        drawList[drawCount++] = { viewProj * model, color };
+    }
 
-           // glm::vec3 color = glm::vec3(0.4f, 0.8f, 0.6f); // simple default color
-            glUniform3fv(colorLoc, 1, &color[0]);
-            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-        }
-        catch (...) {
-            // Entity doesn't have this component, skip
-        }
+    for (size_t i = 0; i < drawCount; ++i)
+    {
+        glUniformMatrix4fv(mvpLoc, 1, GL_FALSE, &drawList[i].mvp[0][0]);
+        glUniform3fv(colorLoc, 1, &drawList[i].color[0]);
+        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
     }
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -8,6 +8,7 @@
 #include "../Engine/ECS/EntityManager.h"
 #include "../Engine/TransformSystem.h"
 #include "../Engine/Streaming/StreamingManager.h"
+#include "../Engine/Core/Memory/FrameArena.h"
 
 //main Renderer
 class Renderer {
@@ -26,11 +27,15 @@ public:
         Entity selectedEntity);
     GLuint GetSceneTextureID() const { return m_SceneTexture; }
 
+    // Scratch for the per-frame draw list; required before rendering
+    void SetFrameArena(FrameArena* arena) { m_FrameArena = arena; }
+
 
 private:
     Shader shader;
     GLuint vao = 0, vbo = 0, ebo = 0;
     GLint mvpLoc = -1, colorLoc = -1;
+    FrameArena* m_FrameArena = nullptr;
 
     //  Framebuffer resources
     GLuint m_FBO = 0;
@@ -14,21 +14,25 @@ void SceneCullingDemo::BuildScene() {
     root.UpdateTransform(Mat4::Identity());
 }
 
-//parallel culling
-void SceneCullingDemo::CullVisible(const Frustum& frustum, JobSystem& jobSystem) {
-    Job* rootJob = jobSystem.CreateJob([]() {});
+//parallel culling: each job flags its nodes, then the visible ones are packed in order
+std::span<SceneNode*> SceneCullingDemo::CullVisible(const Frustum& frustum, JobSystem& jobSystem, FrameArena& arena) {
+    std::span<uint8_t> visible = arena.AllocateArray<uint8_t>(allNodes.size());
+    jobSystem.ParallelFor(0, allNodes.size(), 0, [this, &frustum, visible](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+            visible[i] = FrustumCuller::IsVisible(allNodes[i]->worldBounds, frustum) ? 1 : 0;
+        });
 
-    for (SceneNode* node : allNodes) {
-        Job* cullJob = jobSystem.CreateJob([node, &frustum]() {
-            if (FrustumCuller::IsVisible(node->worldBounds, frustum))
-                std::cout << "[Culling] " << node->name << " visible\n";
-            else
-                std::cout << "[Culling] " << node->name << " culled\n";
-            }, rootJob);
-        jobSystem.Run(cullJob);
-    }
+    size_t count = 0;
+    for (uint8_t flag : visible)
+        count += flag;
 
-    jobSystem.Run(rootJob);
-    jobSystem.Wait(rootJob);
+    std::span<SceneNode*> result = arena.AllocateArray<SceneNode*>(count);
+    size_t next = 0;
+    for (size_t i = 0; i < allNodes.size(); ++i) {
+        std::cout << "[Culling] " << allNodes[i]->name << (visible[i] ? " visible\n" : " culled\n");
+        if (visible[i])
+            result[next++] = allNodes[i];
+    }
+    return result;
 }
 
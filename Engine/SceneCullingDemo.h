@@ -2,7 +2,9 @@
 #include "../Engine/SceneNode.h"
 #include "../Engine/FrustumCuller.h"
 #include "../Engine/JobSystem.h"
+#include "../Engine/Core/Memory/FrameArena.h"
 #include <iostream>
+#include <span>
 
 // ------------------------------------------------------------
 // SceneCullingDemo - builds a simple scene & runs parallel culling
@@ -13,5 +15,6 @@ public:
     std::vector<SceneNode*> allNodes;
 
     void BuildScene();
-    void CullVisible(const Frustum& frustum, JobSystem& jobSystem);
+    // Visible nodes, in frame memory from the arena
+    std::span<SceneNode*> CullVisible(const Frustum& frustum, JobSystem& jobSystem, FrameArena& arena);
 };
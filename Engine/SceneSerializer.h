@@ -26,11 +26,9 @@ public:
         json root;
         root["entities"] = json::array();
 
-        for (uint32_t id = 0; id < 10000; ++id)
+        // Slot order keeps saved files stable across create/destroy churn
+        entities.ForEachAlive([&](Entity e)
         {
-            Entity e{ id };
-            if (!entities.IsAlive(e)) continue;
-
             json entry;
             entry["id"] = e.id;
             entry["name"] = meta.names.count(e.id)
@@ -98,7 +96,7 @@ public:
 
 
             root["entities"].push_back(entry);
-        }
+        });
 
         std::ofstream file(path);
         file << root.dump(4);
@@ -122,9 +120,27 @@ public:
         comps.Clear();
         meta.Clear();
 
-        for (auto& entry : root["entities"])
+        json& saved = root["entities"];
+        entities.Reserve(static_cast<uint32_t>(saved.size()));
+
+        // Components are gathered per type and inserted in one batch each
+        // once every entity is parsed, instead of entity by entity
+        ComponentBatch<TransformComponent> transforms;
+        ComponentBatch<PhysicsComponent> physics;
+        ComponentBatch<ColliderComponent> colliders;
+        ComponentBatch<ScriptComponent> scripts;
+        ComponentBatch<PlayerControllerComponent> controllers;
+        ComponentBatch<CameraFollowComponent> followers;
+
+        // Saved handles carry old generations; map them to the new entities
+        std::unordered_map<EntityID, Entity> savedToLoaded;
+        savedToLoaded.reserve(saved.size());
+        meta.names.reserve(saved.size());
+
+        for (auto& entry : saved)
         {
             Entity e = entities.CreateEntity();
+            savedToLoaded[entry.value("id", e.id)] = e;
             meta.SetName(e, entry.value("name", "Entity " + std::to_string(e.id)));
 
             // -------- Transform --------
@@ -137,7 +153,7 @@ public:
                 t.rotation = { tr["rotation"][0], tr["rotation"][1], tr["rotation"][2] };
                 t.scale = { tr["scale"][0],    tr["scale"][1],    tr["scale"][2] };
 
-                comps.AddComponent(e, t);
+                transforms.Add(e, t);
             }
 
             // -------- Physics --------
@@ -147,7 +163,7 @@ public:
                 p.enabled = entry["physics"].value("enabled", true);
                 p.mass = entry["physics"].value("mass", 1.0f);
 
-                comps.AddComponent(e, p);
+                physics.Add(e, p);
             }
 
             if (entry.contains("collider"))
@@ -163,7 +179,7 @@ public:
 
                 c.isStatic = col.value("isStatic", false);
 
-                comps.AddComponent(e, c);
+                colliders.Add(e, c);
             }
 
             if (entry.contains("script"))
@@ -171,7 +187,7 @@ public:
                 ScriptComponent s;
                 s.ScriptPath = entry["script"].value("path", "");
 
-                comps.AddComponent(e, s);
+                scripts.Add(e, s);
             }
 
             if (entry.contains("playerController"))
@@ -180,7 +196,7 @@ public:
                 pc.moveSpeed = entry["playerController"].value("moveSpeed", 5.0f);
                 pc.lookSpeed = entry["playerController"].value("lookSpeed", 0.1f);
 
-                comps.AddComponent(e, pc);
+                controllers.Add(e, pc);
             }
 
             // -------- Camera Follow --------
@@ -195,9 +211,42 @@ public:
                 c.height = entry["cameraFollow"].value("height", 2.0f);
                 c.smoothness = entry["cameraFollow"].value("smoothness", 10.0f);
 
-                comps.AddComponent(e, c);
+                followers.Add(e, c);
             }
 
         }
+
+        // Targets may be saved after their followers, so remap once all exist
+        for (CameraFollowComponent& follow : followers.components)
+        {
+            auto it = savedToLoaded.find(follow.target.id);
+            follow.target = it != savedToLoaded.end() ? it->second : Entity{};
+        }
+
+        transforms.Flush(comps);
+        physics.Flush(comps);
+        colliders.Flush(comps);
+        scripts.Flush(comps);
+        controllers.Flush(comps);
+        followers.Flush(comps);
     }
+
+private:
+    template<typename T>
+    struct ComponentBatch
+    {
+        std::vector<Entity> owners;
+        std::vector<T> components;
+
+        void Add(Entity e, T component)
+        {
+            owners.push_back(e);
+            components.push_back(std::move(component));
+        }
+
+        void Flush(ComponentManager& comps)
+        {
+            comps.AddComponents(owners, components);
+        }
+    };
 };
\ No newline at end of file
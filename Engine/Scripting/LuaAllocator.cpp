@@ -0,0 +1,131 @@
+#include "pch.h"
+#include "LuaAllocator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+extern "C"
+{
+#include <lua.h>
+#include <lauxlib.h>
+}
+
+// Same message as luaL_newstate's handler; Lua aborts once this returns
+static int LuaPanic(lua_State* L)
+{
+    const char* msg = lua_tostring(L, -1);
+    std::cerr << "[Lua] PANIC: unprotected error in call to Lua API ("
+        << (msg ? msg : "error object is not a string") << ")\n";
+    return 0;
+}
+
+LuaAllocator::LuaAllocator()
+{
+    m_Scripts.push_back({ "<state>" });
+}
+
+lua_State* LuaAllocator::NewState()
+{
+    lua_State* L = lua_newstate(&LuaAllocator::Alloc, this, luaL_makeseed(nullptr));
+    if (L)
+        lua_atpanic(L, &LuaPanic);
+    return L;
+}
+
+void* LuaAllocator::Alloc(void* ud, void* ptr, size_t osize, size_t nsize)
+{
+    auto* self = static_cast<LuaAllocator*>(ud);
+
+    // With no block, osize is the kind of object being made, not a size
+    if (!ptr)
+        osize = 0;
+
+    if (nsize == 0) {
+        self->Release(ptr, osize);
+        return nullptr;
+    }
+    return self->Reallocate(ptr, osize, nsize);
+}
+
+void* LuaAllocator::Reallocate(void* ptr, size_t osize, size_t nsize)
+{
+    constexpr size_t MaxClassSize = SlabAllocator::MaxClassSize;
+    ScriptStats& script = m_Scripts[m_Current];
+
+    if (ptr)
+    {
+        // Still fits the block it has: nothing to move
+        if (osize <= MaxClassSize && nsize <= MaxClassSize
+            && SlabAllocator::classSizeFor(osize) == SlabAllocator::classSizeFor(nsize))
+        {
+            m_LiveBytes += nsize - osize;
+            if (nsize > osize) script.allocatedBytes += nsize - osize;
+            return ptr;
+        }
+
+        if (osize > MaxClassSize && nsize > MaxClassSize)
+        {
+            void* resized = std::realloc(ptr, nsize);
+            if (!resized) return nullptr;
+            m_LiveBytes += nsize - osize;
+            m_LargeBytes += nsize - osize;
+            if (nsize > osize) script.allocatedBytes += nsize - osize;
+            return resized;
+        }
+    }
+
+    void* block = nsize > MaxClassSize ? std::malloc(nsize) : m_Slab.allocate(nsize);
+    if (!block) return nullptr;   // Lua collects and tries again, then raises a memory error
+
+    if (nsize > MaxClassSize)
+        m_LargeBytes += nsize;
+    m_LiveBytes += nsize;
+
+    if (ptr) {
+        std::memcpy(block, ptr, std::min(osize, nsize));
+        Release(ptr, osize);
+        if (nsize > osize) script.allocatedBytes += nsize - osize;
+    }
+    else {
+        script.allocations++;
+        script.allocatedBytes += nsize;
+    }
+    return block;
+}
+
+void LuaAllocator::Release(void* ptr, size_t size)
+{
+    if (!ptr) return;
+
+    m_LiveBytes -= size;
+    if (size > SlabAllocator::MaxClassSize) {
+        m_LargeBytes -= size;
+        std::free(ptr);
+    }
+    else {
+        m_Slab.deallocate(ptr);
+    }
+}
+
+int LuaAllocator::GetScriptId(const std::string& path)
+{
+    auto it = m_ScriptIds.find(path);
+    if (it != m_ScriptIds.end())
+        return it->second;
+
+    int id = static_cast<int>(m_Scripts.size());
+    m_Scripts.push_back({ path });
+    m_ScriptIds.emplace(path, id);
+    return id;
+}
+
+LuaAllocator::Stats LuaAllocator::GetStats() const
+{
+    Stats stats;
+    stats.liveBytes = m_LiveBytes;
+    stats.slabBytes = m_Slab.getStats().totalAllocated;
+    stats.mappedBytes = m_Slab.getMappedBytes();
+    stats.largeBytes = m_LargeBytes;
+    return stats;
+}
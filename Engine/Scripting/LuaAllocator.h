@@ -0,0 +1,85 @@
+#pragma once
+#include "../Core/Memory/SlabAllocator.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct lua_State;
+
+// ------------------------------------------------------------
+// LuaAllocator - the lua_Alloc for the engine's Lua state
+//
+// Every table, string, closure and userdata Lua makes lands in a
+// SlabAllocator size class instead of the process heap, so script
+// churn reuses the same few pages rather than fragmenting malloc's.
+// Blocks bigger than the largest class go to malloc; Lua passes the
+// current size of every block it frees or resizes, which is enough to
+// tell the two apart.
+//
+// Allocations are charged to the script that is running, set with a
+// ScriptScope around each call into Lua. Live bytes are only known
+// for the whole state: the collector frees objects whenever it runs,
+// whoever made them, so per script we count what each one allocates.
+// ------------------------------------------------------------
+class LuaAllocator {
+public:
+    struct ScriptStats {
+        std::string path;
+        uint64_t allocations = 0;       // since the state was made
+        uint64_t allocatedBytes = 0;
+    };
+
+    struct Stats {
+        size_t liveBytes = 0;           // what Lua holds, as it counts it
+        size_t slabBytes = 0;           // the same blocks rounded up to their classes
+        size_t mappedBytes = 0;         // slab pages taken from the OS
+        size_t largeBytes = 0;          // blocks past the largest class, on malloc
+    };
+
+    // Charges Lua's allocations to a script until it goes out of scope
+    class ScriptScope {
+    public:
+        ScriptScope(LuaAllocator& allocator, int scriptId)
+            : m_Allocator(allocator), m_Previous(allocator.m_Current) {
+            if (scriptId >= 0) allocator.m_Current = scriptId;
+        }
+        ~ScriptScope() { m_Allocator.m_Current = m_Previous; }
+
+        ScriptScope(const ScriptScope&) = delete;
+        ScriptScope& operator=(const ScriptScope&) = delete;
+
+    private:
+        LuaAllocator& m_Allocator;
+        int m_Previous;
+    };
+
+    LuaAllocator();
+
+    LuaAllocator(const LuaAllocator&) = delete;
+    LuaAllocator& operator=(const LuaAllocator&) = delete;
+
+    // A new state that allocates through this; lua_close it before
+    // this allocator goes away
+    lua_State* NewState();
+
+    static void* Alloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+    // Same id every time for the same path; id 0 is the state itself
+    // (standard libraries, engine bindings, anything outside a scope)
+    int GetScriptId(const std::string& path);
+
+    Stats GetStats() const;
+    const std::vector<ScriptStats>& GetScriptStats() const { return m_Scripts; }
+
+private:
+    void* Reallocate(void* ptr, size_t osize, size_t nsize);
+    void Release(void* ptr, size_t size);
+
+    SlabAllocator m_Slab;
+    size_t m_LiveBytes = 0;
+    size_t m_LargeBytes = 0;
+
+    int m_Current = 0;
+    std::vector<ScriptStats> m_Scripts;
+    std::unordered_map<std::string, int> m_ScriptIds;
+};
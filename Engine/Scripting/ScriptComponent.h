@@ -10,4 +10,6 @@ struct ScriptComponent
     int OnDestroy = -1;
 
     bool Started = false;
+
+    int MemoryId = -1;      // who LuaAllocator charges this script's allocations to
 };
@@ -34,6 +34,9 @@ static int Lua_InputMoveRight(lua_State* L);
 static int Lua_InputJumpPressed(lua_State* L);
 static int Lua_InputToggleCameraPressed(lua_State* L);
 
+// World Lua API
+static int Lua_WorldDestroy(lua_State* L);
+
 // Physics Lua API
 static int Lua_PhysicsSetVelocity(lua_State* L);
 static int Lua_PhysicsAddImpulse(lua_State* L);
@@ -229,7 +232,7 @@ void ScriptSystem::Init(ComponentManager* cm)
 	g_ScriptSystem = this;
     components = cm;
 
-    m_L = luaL_newstate();
+    m_L = m_Memory.NewState();
     luaL_openlibs(m_L);
 
     // ---------------- Transform API ----------------
@@ -285,6 +288,14 @@ void ScriptSystem::Init(ComponentManager* cm)
     lua_setfield(m_L, -2, "IsGrounded");
 
     lua_setglobal(m_L, "Physics");
+
+    // ---------------- World API ----------------
+    lua_newtable(m_L);
+
+    lua_pushcfunction(m_L, Lua_WorldDestroy);
+    lua_setfield(m_L, -2, "Destroy");
+
+    lua_setglobal(m_L, "World");
     //lua_pop(m_L, 1);
 }
 
@@ -332,6 +343,9 @@ void ScriptSystem::LoadScript(ScriptComponent& script)
         return;
     }
 
+    script.MemoryId = m_Memory.GetScriptId(script.ScriptPath);
+    LuaAllocator::ScriptScope memoryScope(m_Memory, script.MemoryId);
+
     if (luaL_dofile(m_L, fullPath.string().c_str()) != LUA_OK)
     {
         const char* err = lua_tostring(m_L, -1);
@@ -415,6 +429,8 @@ void ScriptSystem::CallFunction(int fnRef, Entity entity, float dt)
 
 void ScriptSystem::Update(Entity entity, ScriptComponent& script, float dt)
 {
+    LuaAllocator::ScriptScope memoryScope(m_Memory, script.MemoryId);
+
     if (!script.Started)
     {
         CallFunction(script.OnStart, entity, 0.0f);
@@ -467,6 +483,7 @@ static int Lua_Translate(lua_State* L)
     t.position.x += x;
     t.position.y += y;
     t.position.z += z;
+    ScriptSystem::Get().GetComponents()->MarkChanged<TransformComponent>(e);
 
     return 0;
 }
@@ -520,6 +537,15 @@ static int Lua_PhysicsIsGrounded(lua_State* L)
     return 1;
 }
 
+// Deferred: the script pass is still iterating ScriptComponents
+static int Lua_WorldDestroy(lua_State* L)
+{
+    LuaEntity* le = (LuaEntity*)lua_touserdata(L, 1);
+    if (!le) return 0;
+
+    ScriptSystem::Get().GetCommandBuffer().DestroyEntity(le->entity);
+    return 0;
+}
 
 void ScriptSystem::SetInputSystem(InputSystem* input)
 {
@@ -1,5 +1,7 @@
 #pragma once
 #include "../ECS/Entity.h"
+#include "../ECS/EntityCommandBuffer.h"
+#include "LuaAllocator.h"
 #include <string>
 #include <filesystem>
 
@@ -25,6 +27,9 @@ public:
     void LoadScript(ScriptComponent& script);
 
     ComponentManager* GetComponents() const { return components; }
+
+    // Structural changes requested by scripts; played back after the script pass
+    EntityCommandBuffer& GetCommandBuffer() { return m_Commands; }
     static ScriptSystem& Get();
     void Update(Entity entity, ScriptComponent& script, float dt);
 	bool ValidateScriptText(const std::string& scriptText, std::string& errorOut);
@@ -34,9 +39,14 @@ public:
 
 
     void SetInputSystem(InputSystem* input);
+
+    // Lua's memory: the whole state, and what each script allocates
+    const LuaAllocator& GetMemory() const { return m_Memory; }
+
     InputSystem* m_InputSystem = nullptr;
 
 private:
+    LuaAllocator m_Memory;
     struct lua_State* m_L = nullptr;
 
     int GetFunctionRef(const char* name);
@@ -44,5 +54,6 @@ private:
     ComponentManager* components = nullptr;
     
     std::vector<ScriptError> m_Errors;
+    EntityCommandBuffer m_Commands;
 
 };
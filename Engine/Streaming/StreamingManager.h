@@ -44,6 +44,13 @@ public:
 
         m_Loader.Update();
 
+        // Finished loads; a chunk unloaded meanwhile just drops its data
+        for (LoadedAsset& asset : m_Loader.TakeCompleted()) {
+            auto it = m_Chunks.find(asset.name);
+            if (it != m_Chunks.end())
+                it->second.loaded = true;
+        }
+
         // Fake unloading log every few frames
         for (auto it = m_Chunks.begin(); it != m_Chunks.end();) {
             if ((rand() % 200) == 0) {
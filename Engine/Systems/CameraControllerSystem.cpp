@@ -25,19 +25,8 @@ void CameraControllerSystem::Update(
     float dt
 )
 {
-    for (EntityID id = 0; id < entities.GetMaxEntities(); ++id)
+    for (auto [camEntity, follow] : components.View<CameraFollowComponent>())
     {
-        Entity camEntity{ id };
-
-        if (!entities.IsAlive(camEntity))
-            continue;
-
-        if (!components.HasComponent<CameraFollowComponent>(camEntity))
-            continue;
-
-        auto& follow =
-            components.GetComponent<CameraFollowComponent>(camEntity);
-
         Entity target = follow.target;
 
         if (!entities.IsAlive(target))
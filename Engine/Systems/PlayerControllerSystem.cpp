@@ -18,31 +18,9 @@ void PlayerControllerSystem::Update(
     float dt
 )
 {
-    for (EntityID id = 0; id < entities.GetMaxEntities(); ++id)
+    for (auto [e, pc, transform, physics] :
+        components.View<PlayerControllerComponent, TransformComponent, PhysicsComponent>())
     {
-        Entity e{ id };
-
-        if (!entities.IsAlive(e))
-            continue;
-
-        if (!components.HasComponent<PlayerControllerComponent>(e))
-            continue;
-
-        if (!components.HasComponent<TransformComponent>(e))
-            continue;
-
-        if (!components.HasComponent<PhysicsComponent>(e))
-            continue;
-
-        auto& pc =
-            components.GetComponent<PlayerControllerComponent>(e);
-
-        auto& transform =
-            components.GetComponent<TransformComponent>(e);
-
-        auto& physics =
-            components.GetComponent<PhysicsComponent>(e);
-
         // ============================================================
         // MOVEMENT INPUT → VELOCITY (X/Z ONLY)
         // ============================================================
@@ -107,6 +85,7 @@ void PlayerControllerSystem::Update(
         {
             // Rotate player yaw
             transform.rotation.y += mouseDX * pc.lookSpeed;
+            components.MarkChanged<TransformComponent>(e);
 
             if (pc.cameraMode == CameraMode::FirstPerson)
             {
@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "SystemGraph.h"
+#include "../Profiler.h"
+
+#include <algorithm>
+
+static bool Overlaps(const std::vector<ComponentTypeIndex>& a, const std::vector<ComponentTypeIndex>& b)
+{
+    for (ComponentTypeIndex type : a)
+        if (std::find(b.begin(), b.end(), type) != b.end())
+            return true;
+    return false;
+}
+
+bool SystemGraph::System::ConflictsWith(const System& other) const
+{
+    return Overlaps(m_Writes, other.m_Writes)
+        || Overlaps(m_Writes, other.m_Reads)
+        || Overlaps(m_Reads, other.m_Writes);
+}
+
+SystemGraph::System& SystemGraph::Add(std::string name, SystemFn fn)
+{
+    m_Systems.push_back(std::unique_ptr<System>(new System(std::move(name), std::move(fn))));
+    m_Built = false;
+    return *m_Systems.back();
+}
+
+void SystemGraph::Build()
+{
+    // reaches[j][i]: system i is already ordered before system j
+    const size_t count = m_Systems.size();
+    std::vector<std::vector<char>> reaches(count, std::vector<char>(count, 0));
+
+    for (size_t j = 0; j < count; ++j)
+    {
+        System& system = *m_Systems[j];
+        system.m_After.clear();
+
+        // Newest first, so an edge to a later system can make an edge to
+        // an earlier one redundant
+        for (size_t i = j; i-- > 0; )
+        {
+            if (reaches[j][i] || !system.ConflictsWith(*m_Systems[i]))
+                continue;
+
+            system.m_After.push_back(static_cast<uint32_t>(i));
+            reaches[j][i] = 1;
+            for (size_t k = 0; k < i; ++k)
+                reaches[j][k] |= reaches[i][k];
+        }
+    }
+
+    m_Built = true;
+}
+
+void SystemGraph::Run(JobSystem& jobs, FrameArena& arena, float dt)
+{
+    if (!m_Built)
+        Build();
+
+    // All systems are children of one frame job, so waiting on it
+    // waits for everything
+    Job* frame = jobs.CreateJob([]() {});
+
+    m_Jobs.clear();
+    for (auto& system : m_Systems)
+    {
+        const System* target = system.get();
+        m_Jobs.push_back(jobs.CreateJob([target, &arena, dt]() {
+            PROFILE_ZONE(target->m_Name.c_str());
+            target->m_Fn(dt, arena);
+            }, frame));
+    }
+
+    for (size_t j = 0; j < m_Systems.size(); ++j)
+        for (uint32_t before : m_Systems[j]->m_After)
+            jobs.AddDependency(m_Jobs[before], m_Jobs[j]);
+
+    for (Job* job : m_Jobs)
+        jobs.Run(job, JobPriority::Frame);
+
+    jobs.Wait(jobs.Run(frame, JobPriority::Frame));
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+#include "../ECS/ComponentTypeId.h"
+#include "../JobSystem.h"
+#include "../Core/Memory/FrameArena.h"
+
+// ------------------------------------------------------------
+// SystemGraph - per-frame schedule of engine systems
+//
+// Each system declares the data it reads and writes, keyed by type:
+// component types, and shared objects such as Camera or InputSystem.
+// Two systems conflict when one writes something the other reads or
+// writes. Conflicting systems keep the order they were added in;
+// everything else may run at the same time. Dependencies are worked
+// out once (Build); Run then issues one job per system, wired as a
+// DAG, and waits for the whole frame.
+//
+// Structural ECS changes must go through command buffers and be
+// played back after Run, since systems iterate concurrently.
+//
+// Systems get the frame arena for per-frame scratch (gathered lists,
+// culling results); it hands each thread its own memory, so systems
+// running side by side never share a buffer.
+// ------------------------------------------------------------
+class SystemGraph
+{
+public:
+    using SystemFn = std::function<void(float dt, FrameArena& arena)>;
+
+    class System
+    {
+    public:
+        template<typename... Ts>
+        System& Reads() { (m_Reads.push_back(ComponentTypeId<Ts>()), ...); return *this; }
+
+        template<typename... Ts>
+        System& Writes() { (m_Writes.push_back(ComponentTypeId<Ts>()), ...); return *this; }
+
+        const std::string& GetName() const { return m_Name; }
+
+    private:
+        friend class SystemGraph;
+
+        System(std::string name, SystemFn fn) : m_Name(std::move(name)), m_Fn(std::move(fn)) {}
+
+        bool ConflictsWith(const System& other) const;
+
+        std::string m_Name;
+        SystemFn m_Fn;
+        std::vector<ComponentTypeIndex> m_Reads;
+        std::vector<ComponentTypeIndex> m_Writes;
+        std::vector<uint32_t> m_After;      // systems that must finish first
+    };
+
+    // Adds a system; declare its access on the returned System
+    System& Add(std::string name, SystemFn fn);
+
+    // Works out dependencies from the declared access. Called by Run
+    // when systems were added since the last build.
+    void Build();
+
+    // Runs every system once and returns when all have finished
+    void Run(JobSystem& jobs, FrameArena& arena, float dt);
+
+    size_t GetSystemCount() const { return m_Systems.size(); }
+
+    // Indices of the systems 'index' waits for (valid after Build)
+    const std::vector<uint32_t>& GetDependencies(size_t index) const { return m_Systems[index]->m_After; }
+
+private:
+    std::vector<std::unique_ptr<System>> m_Systems;   // stable addresses for the builder
+    std::vector<Job*> m_Jobs;                         // per-frame scratch
+    bool m_Built = false;
+};
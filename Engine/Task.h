@@ -0,0 +1,335 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <atomic>
+#include <utility>
+#include <type_traits>
+#include <cassert>
+#include "JobSystem.h"
+
+// ------------------------------------------------------------
+// Task<T> - coroutine that runs on JobSystem workers
+//
+// A task does nothing until it is started (Start) or awaited by another
+// task, which runs it straight away and is resumed when it co_returns.
+// Inside a task you can co_await:
+//   - another Task<U>           -> its U (exceptions propagate)
+//   - Schedule(js, priority)    -> continue as a job on a worker
+//   - RunJob(js, job, priority) -> run a job; resume once it and all its
+//                                  children have completed
+//   - RunIO(js, fn, priority)   -> call fn on the I/O lane; resume on a
+//                                  worker with what it returned
+// Every resume is queued as a job, so a suspended task holds no thread.
+//
+// The owner polls IsReady() (e.g. once per frame) and then reads
+// Result(). A started task must not be destroyed before it is ready.
+// ------------------------------------------------------------
+template<typename T = void>
+class Task;
+
+namespace Detail
+{
+    inline Job* CreateResumeJob(JobSystem& js, std::coroutine_handle<> coroutine)
+    {
+        return js.CreateJob([coroutine]() { coroutine.resume(); });
+    }
+
+    class TaskPromiseBase
+    {
+    public:
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // Hands control straight to the awaiting task, if there is one
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept { return false; }
+
+            template<typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> self) noexcept
+            {
+                TaskPromiseBase& promise = self.promise();
+
+                // Read the continuation first: once m_Ready is set the
+                // owner may destroy this frame
+                std::coroutine_handle<> continuation = promise.m_Continuation;
+                promise.m_Ready.store(true, std::memory_order_release);
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void unhandled_exception() noexcept { m_Exception = std::current_exception(); }
+
+        bool IsReady() const { return m_Ready.load(std::memory_order_acquire); }
+
+        void Rethrow() const
+        {
+            if (m_Exception)
+                std::rethrow_exception(m_Exception);
+        }
+
+        std::coroutine_handle<> m_Continuation;   // awaiting task, set before we start
+        std::atomic<bool> m_Ready{ false };
+        std::exception_ptr m_Exception;
+    };
+
+    template<typename T>
+    class TaskPromise : public TaskPromiseBase
+    {
+    public:
+        Task<T> get_return_object() noexcept;
+
+        template<typename U>
+        void return_value(U&& value) { m_Value.emplace(std::forward<U>(value)); }
+
+        T& Value() { Rethrow(); return *m_Value; }
+
+    private:
+        std::optional<T> m_Value;
+    };
+
+    template<>
+    class TaskPromise<void> : public TaskPromiseBase
+    {
+    public:
+        Task<void> get_return_object() noexcept;
+
+        void return_void() noexcept {}
+        void Value() { Rethrow(); }
+    };
+}
+
+template<typename T>
+class Task
+{
+public:
+    using promise_type = Detail::TaskPromise<T>;
+
+    Task() = default;
+    explicit Task(std::coroutine_handle<promise_type> handle) : m_Handle(handle) {}
+
+    Task(Task&& other) noexcept
+        : m_Handle(std::exchange(other.m_Handle, {})), m_Started(other.m_Started) {}
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            Destroy();
+            m_Handle = std::exchange(other.m_Handle, {});
+            m_Started = other.m_Started;
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() { Destroy(); }
+
+    // Queues the task as a job; it runs until its first suspension there
+    void Start(JobSystem& js, JobPriority priority = JobPriority::Normal)
+    {
+        assert(m_Handle && !m_Started && "Task already started!");
+        m_Started = true;
+        js.Run(Detail::CreateResumeJob(js, m_Handle), priority);
+    }
+
+    bool IsValid() const { return static_cast<bool>(m_Handle); }
+
+    // Never blocks; safe to call from any thread
+    bool IsReady() const { return m_Handle && m_Handle.promise().IsReady(); }
+
+    // Only once IsReady; rethrows what the task threw
+    decltype(auto) Result() { return m_Handle.promise().Value(); }
+
+    // co_await from another task: run this one now, resume there when done
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter
+        {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return false; }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                handle.promise().m_Continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume()
+            {
+                if constexpr (std::is_void_v<T>)
+                    handle.promise().Value();
+                else
+                    return std::move(handle.promise().Value());
+            }
+        };
+
+        assert(m_Handle && !m_Started && "Task already started!");
+        m_Started = true;
+        return Awaiter{ m_Handle };
+    }
+
+private:
+    void Destroy()
+    {
+        if (!m_Handle)
+            return;
+        assert((!m_Started || IsReady()) && "Destroying a Task that is still running!");
+        m_Handle.destroy();
+        m_Handle = {};
+    }
+
+    std::coroutine_handle<promise_type> m_Handle;
+    bool m_Started = false;
+};
+
+namespace Detail
+{
+    template<typename T>
+    Task<T> TaskPromise<T>::get_return_object() noexcept
+    {
+        return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> TaskPromise<void>::get_return_object() noexcept
+    {
+        return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+    }
+
+    class ScheduleAwaiter
+    {
+    public:
+        ScheduleAwaiter(JobSystem& js, JobPriority priority) : m_JobSystem(js), m_Priority(priority) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> coroutine)
+        {
+            // Copy out first: the job may resume (and finish) the
+            // coroutine before Run returns
+            JobSystem& js = m_JobSystem;
+            JobPriority priority = m_Priority;
+            js.Run(CreateResumeJob(js, coroutine), priority);
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        JobSystem& m_JobSystem;
+        JobPriority m_Priority;
+    };
+
+    class JobAwaiter
+    {
+    public:
+        JobAwaiter(JobSystem& js, Job* job, JobPriority priority) : m_JobSystem(js), m_Job(job), m_Priority(priority) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> coroutine)
+        {
+            JobSystem& js = m_JobSystem;
+            Job* job = m_Job;
+            JobPriority priority = m_Priority;
+
+            Job* resume = CreateResumeJob(js, coroutine);
+            js.AddDependency(job, resume);
+            js.Run(resume, priority);
+            js.Run(job, priority);
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        JobSystem& m_JobSystem;
+        Job* m_Job;
+        JobPriority m_Priority;
+    };
+
+    template<typename Func>
+    class IOAwaiter
+    {
+    public:
+        using Result = std::invoke_result_t<Func&>;
+
+        IOAwaiter(JobSystem& js, Func fn, JobPriority priority)
+            : m_JobSystem(js), m_Fn(std::move(fn)), m_Priority(priority) {}
+
+        // A job holds on to this awaiter while it is suspended
+        IOAwaiter(const IOAwaiter&) = delete;
+        IOAwaiter& operator=(const IOAwaiter&) = delete;
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> coroutine)
+        {
+            m_Coroutine = coroutine;
+            JobSystem& js = m_JobSystem;
+            JobPriority priority = m_Priority;
+            js.RunIO(js.CreateJob([this]() { Complete(); }), priority);
+        }
+
+        Result await_resume()
+        {
+            if (m_Exception)
+                std::rethrow_exception(m_Exception);
+            if constexpr (!std::is_void_v<Result>)
+                return std::move(*m_Result);
+        }
+
+    private:
+        // On the I/O thread: run fn, then go back to the frame workers
+        void Complete()
+        {
+            try {
+                if constexpr (std::is_void_v<Result>)
+                    m_Fn();
+                else
+                    m_Result.emplace(m_Fn());
+            }
+            catch (...) {
+                m_Exception = std::current_exception();
+            }
+
+            JobSystem& js = m_JobSystem;
+            JobPriority priority = m_Priority;
+            js.Run(CreateResumeJob(js, m_Coroutine), priority);
+        }
+
+        struct Empty {};
+
+        JobSystem& m_JobSystem;
+        Func m_Fn;
+        JobPriority m_Priority;
+        std::coroutine_handle<> m_Coroutine;
+        std::conditional_t<std::is_void_v<Result>, Empty, std::optional<Result>> m_Result;
+        std::exception_ptr m_Exception;
+    };
+}
+
+// co_await Schedule(js): continue on a JobSystem worker
+inline Detail::ScheduleAwaiter Schedule(JobSystem& js, JobPriority priority = JobPriority::Normal)
+{
+    return { js, priority };
+}
+
+// co_await RunJob(js, job): runs a job that has not been Run yet and
+// resumes once it and its children have completed
+inline Detail::JobAwaiter RunJob(JobSystem& js, Job* job, JobPriority priority = JobPriority::Normal)
+{
+    return { js, job, priority };
+}
+
+// co_await RunIO(js, fn): calls fn on the I/O lane, so blocking reads
+// never hold a frame worker, and resumes on a worker with its result.
+// fn is moved (or copied) into the awaiter, so an inline lambda is fine.
+template<typename Func>
+Detail::IOAwaiter<std::decay_t<Func>> RunIO(JobSystem& js, Func&& fn, JobPriority priority = JobPriority::Normal)
+{
+    return { js, std::forward<Func>(fn), priority };
+}
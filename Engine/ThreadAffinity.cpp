@@ -0,0 +1,114 @@
+#include "pch.h"
+#include "ThreadAffinity.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <fstream>
+#include <algorithm>
+#else
+#include <thread>
+#endif
+
+std::vector<uint32_t> GetUsableCpus(bool physicalOnly)
+{
+    std::vector<uint32_t> cpus;
+
+#if defined(_WIN32)
+    DWORD_PTR processMask = 0, systemMask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+        processMask = ~DWORD_PTR(0);
+
+    DWORD_PTR allowed = 0;
+    DWORD length = 0;
+    GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &length);
+    std::vector<unsigned char> buffer(length);
+    auto* info = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data());
+
+    if (length && GetLogicalProcessorInformationEx(RelationProcessorCore, info, &length))
+    {
+        for (DWORD offset = 0; offset < length; )
+        {
+            auto* core = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+            const GROUP_AFFINITY& group = core->Processor.GroupMask[0];
+            DWORD_PTR mask = group.Group == 0 ? (group.Mask & processMask) : 0;
+
+            // Lowest allowed logical CPU stands for the whole core
+            if (physicalOnly)
+                mask &= ~mask + 1;
+            allowed |= mask;
+            offset += core->Size;
+        }
+    }
+    else
+    {
+        allowed = processMask;
+    }
+
+    for (uint32_t cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu)
+        if (allowed & (DWORD_PTR(1) << cpu))
+            cpus.push_back(cpu);
+
+#elif defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        return cpus;
+
+    for (uint32_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (!CPU_ISSET(cpu, &allowed))
+            continue;
+
+        if (physicalOnly)
+        {
+            // "0,16" or "0-1": the first entry is the core's lowest CPU
+            std::ifstream siblings("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/thread_siblings_list");
+            uint32_t first = cpu;
+            if (siblings >> first && first != cpu && CPU_ISSET(first, &allowed))
+                continue;
+        }
+        cpus.push_back(cpu);
+    }
+
+#else
+    (void)physicalOnly;
+    for (uint32_t cpu = 0; cpu < std::thread::hardware_concurrency(); ++cpu)
+        cpus.push_back(cpu);
+#endif
+
+    return cpus;
+}
+
+bool PinCurrentThread(uint32_t cpu)
+{
+#if defined(_WIN32)
+    if (cpu >= sizeof(DWORD_PTR) * 8)
+        return false;
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#elif defined(__linux__)
+    if (cpu >= CPU_SETSIZE)
+        return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+void SetCurrentThreadName(const std::string& name)
+{
+#if defined(_WIN32)
+    std::wstring wide(name.begin(), name.end());
+    SetThreadDescription(GetCurrentThread(), wide.c_str());
+#elif defined(__linux__)
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#else
+    (void)name;
+#endif
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// ------------------------------------------------------------
+// Thread placement and naming, for the calling thread.
+//
+// CPUs are logical processor indices as the OS numbers them. Windows
+// support covers processor group 0 (the first 64 logical CPUs); Linux
+// reads SMT topology from sysfs. Elsewhere pinning is a no-op and every
+// CPU counts as a physical core.
+// ------------------------------------------------------------
+
+// Logical CPUs this process may run on, ascending. With physicalOnly,
+// one per physical core: SMT siblings after the first are dropped.
+std::vector<uint32_t> GetUsableCpus(bool physicalOnly);
+
+// Restricts the calling thread to one logical CPU; false if refused.
+bool PinCurrentThread(uint32_t cpu);
+
+// Name shown in debuggers, perf and profilers. Linux keeps the first
+// 15 characters.
+void SetCurrentThreadName(const std::string& name);
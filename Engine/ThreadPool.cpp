@@ -1,73 +1,499 @@
 #include "pch.h"
 #include "ThreadPool.h"
+#include "ThreadAffinity.h"
+#include "Profiler.h"
 #include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+    // Which pool (if any) the current thread works for, and as which worker
+    thread_local ThreadPool* t_Pool = nullptr;
+    thread_local size_t t_WorkerIndex = 0;
+
+    // Rounds of fruitless searching before an idle worker goes to sleep
+    constexpr int IdleSpinRounds = 64;
+
+    uint64_t NowNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Whole string as a non-negative decimal. std::stoull alone would
+    // wrap "-1" to ULLONG_MAX and read "8abc" as 8.
+    bool ParseCount(const std::string& text, size_t& out)
+    {
+        if (text.empty() || text[0] < '0' || text[0] > '9')
+            return false;
+        try
+        {
+            size_t pos = 0;
+            unsigned long long value = std::stoull(text, &pos);
+            if (pos != text.size() || value > SIZE_MAX)
+                return false;
+            out = static_cast<size_t>(value);
+            return true;
+        }
+        catch (const std::exception&)
+        {
+            return false;   // out of range
+        }
+    }
+}
+
+ThreadPool::Config ThreadPool::Config::Load(const std::unordered_map<std::string, std::string>& values,
+    const std::string& prefix)
+{
+    return Load(values, prefix, Config());
+}
+
+ThreadPool::Config ThreadPool::Config::Load(const std::unordered_map<std::string, std::string>& values,
+    const std::string& prefix, const Config& defaults)
+{
+    Config config = defaults;
+    auto find = [&](const char* key) -> const std::string* {
+        auto it = values.find(prefix + "_" + key);
+        return it != values.end() ? &it->second : nullptr;
+    };
+
+    if (const std::string* threads = find("threads"))
+    {
+        // More than a few threads per CPU is a typo, not a setting
+        size_t cpus = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        size_t count = 0;
+        if (!ParseCount(*threads, count))
+            std::cerr << "[ThreadPool] Invalid " << prefix << "_threads: " << *threads << "\n";
+        else if (count > cpus * MaxThreadsPerCpu)
+        {
+            std::cerr << "[ThreadPool] " << prefix << "_threads " << count << " capped at " << cpus * MaxThreadsPerCpu << "\n";
+            config.threadCount = cpus * MaxThreadsPerCpu;
+        }
+        else
+            config.threadCount = count ? count : cpus;
+    }
+
+    if (const std::string* first = find("first_cpu"))
+    {
+        size_t cpu = 0;
+        if (ParseCount(*first, cpu))
+            config.firstCpu = cpu;
+        else
+            std::cerr << "[ThreadPool] Invalid " << prefix << "_first_cpu: " << *first << "\n";
+    }
+
+    if (const std::string* affinity = find("affinity"))
+    {
+        if (*affinity == "none")          config.affinity = Affinity::None;
+        else if (*affinity == "cores")    config.affinity = Affinity::Cores;
+        else if (*affinity == "physical") config.affinity = Affinity::PhysicalCores;
+        else std::cerr << "[ThreadPool] Unknown " << prefix << "_affinity: " << *affinity << "\n";
+    }
+
+    if (const std::string* name = find("name"))
+        config.name = *name;
+
+    return config;
+}
 
 ThreadPool::ThreadPool(size_t threadCount)
+    : ThreadPool(Config{ threadCount })
 {
+}
+
+ThreadPool::ThreadPool(const Config& config)
+    : m_Name(config.name)
+{
+    size_t threadCount = config.threadCount;
     if (threadCount == 0)
         threadCount = 1;
+    m_LastStats.resize(threadCount + 1);
+
+    // CPU per worker, or -1 to leave it unpinned. More workers than
+    // CPUs wrap around and share.
+    std::vector<int> cpus(threadCount, -1);
+    if (config.affinity != Affinity::None)
+    {
+        std::vector<uint32_t> usable = GetUsableCpus(config.affinity == Affinity::PhysicalCores);
+        for (size_t i = 0; i < threadCount && !usable.empty(); ++i)
+            cpus[i] = static_cast<int>(usable[(config.firstCpu + i) % usable.size()]);
+        if (usable.size() < config.firstCpu + threadCount)
+            std::cout << "[ThreadPool] " << threadCount << " " << m_Name << " threads on " << usable.size()
+                << " usable CPUs; some share a CPU.\n";
+    }
 
+    // Every deque must exist before any worker starts stealing
     m_Workers.reserve(threadCount);
     for (size_t i = 0; i < threadCount; ++i)
     {
-        m_Workers.emplace_back([this] { WorkerLoop(); });
+        m_Workers.push_back(std::make_unique<Worker>());
+        m_Workers.back()->rng = static_cast<uint32_t>(i * 2654435761u + 1);
     }
 
-    std::cout << "[ThreadPool] Started " << m_Workers.size() << " threads.\n";
+    for (size_t i = 0; i < threadCount; ++i)
+        m_Workers[i]->thread = std::thread([this, i, cpu = cpus[i]] { WorkerLoop(i, cpu); });
+
+    std::cout << "[ThreadPool] Started " << m_Workers.size() << " " << m_Name << " threads"
+        << (config.affinity == Affinity::None ? "" : ", pinned") << ".\n";
 }
 
 ThreadPool::~ThreadPool()
+{
+    Stop();
+    Join();
+    Drain();
+
+    std::cout << "[ThreadPool] Shutdown complete.\n";
+}
+
+void ThreadPool::Stop()
 {
     m_Stop = true;
+    {
+        std::scoped_lock lock(m_SleepMutex);
+        ++m_WakeEpoch;
+    }
     m_Condition.notify_all();
+}
 
-    for (auto& thread : m_Workers)
-        if (thread.joinable()) thread.join();
+void ThreadPool::Join()
+{
+    for (auto& worker : m_Workers)
+        if (worker->thread.joinable()) worker->thread.join();
+}
 
-    std::cout << "[ThreadPool] Shutdown complete.\n";
+void ThreadPool::Drain()
+{
+    // Anything submitted while the workers were exiting runs here, so
+    // intrusive tasks are not left dangling and wrappers are freed.
+    // Tasks these submit run inline (we are stopped), so one pass does.
+    Task* task = nullptr;
+    for (size_t p = 0; p < PriorityCount; ++p)
+    {
+        while (m_Injection[p].TryPop(task))
+            Execute(task);
+        for (auto& worker : m_Workers)
+            while ((task = worker->deques[p].Pop()) != nullptr)
+                Execute(task);
+    }
 }
 
-void ThreadPool::Submit(std::function<void()> task)
+void ThreadPool::Submit(std::function<void()> task, Priority priority)
 {
-    if (m_Stop) return; // guard against post-shutdown submit
+    FunctionTask* node = new FunctionTask();
+    node->execute = [](Task* self) {
+        std::unique_ptr<FunctionTask> owned(static_cast<FunctionTask*>(self));
+        owned->function();
+    };
+    node->function = std::move(task);
+    Submit(node, priority);
+}
 
+void ThreadPool::Submit(Task* task, Priority priority)
+{
+    // Stopping: run it here rather than drop it, or whoever waits on it
+    // (JobSystem::Wait, a parent job) would wait forever
+    if (m_Stop) {
+        Execute(task);
+        return;
+    }
+
+    Push(task, priority);
+}
+
+void ThreadPool::Push(Task* node, Priority priority)
+{
+    const size_t p = static_cast<size_t>(priority);
+    if (t_Pool == this)
+    {
+        Worker& self = *m_Workers[t_WorkerIndex];
+        self.deques[p].Push(node);
+
+        size_t depth = 0;
+        for (const auto& deque : self.deques)
+            depth += deque.Size();
+        CountMax(self.counters.queueHighWater, depth, false);
+    }
+    else
     {
-        std::scoped_lock lock(m_QueueMutex);
-        m_Tasks.push(std::move(task));
+        // Full injection queue: wait for the workers to drain some of it
+        while (!m_Injection[p].TryPush(node))
+            std::this_thread::yield();
+        CountMax(m_HelperCounters.queueHighWater, m_Injection[p].Size(), true);
+    }
+
+    // Pairs with the fence in WorkerLoop: either the sleeper sees the new
+    // task on its final check, or we see it counted as asleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_Sleepers.load(std::memory_order_relaxed) > 0)
+        WakeOne();
+}
+
+void ThreadPool::WakeOne()
+{
+    {
+        std::scoped_lock lock(m_SleepMutex);
+        ++m_WakeEpoch;
     }
     m_Condition.notify_one();
 }
 
-void ThreadPool::WorkerLoop()
+ThreadPool::Task* ThreadPool::FindTask(size_t index)
 {
-    while (true)
+    Worker& self = *m_Workers[index];
+
+    // Every source of one priority before any of the next: stealing a
+    // High task beats popping our own Normal one
+    for (size_t p = 0; p < PriorityCount; ++p)
     {
-        std::function<void()> job;
+        if (Task* task = self.deques[p].Pop())
+            return task;
 
-        {
-            std::unique_lock lock(m_QueueMutex);
-            m_Condition.wait(lock, [this] { return m_Stop || !m_Tasks.empty(); });
+        Task* task = nullptr;
+        if (m_Injection[p].TryPop(task))
+            return task;
+
+        if (Task* stolen = StealTask(index, self.rng, p)) {
+            Count(self.counters.steals, 1, false);
+            return stolen;
+        }
+    }
 
-            if (m_Stop && m_Tasks.empty())
-                return;
+    return nullptr;
+}
+
+ThreadPool::Task* ThreadPool::StealTask(size_t skip, uint32_t& rng, size_t priority)
+{
+    // Start at a random victim so thieves spread out
+    const size_t count = m_Workers.size();
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+
+    size_t start = rng % count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t victim = (start + i) % count;
+        if (victim == skip)
+            continue;
+        if (Task* task = m_Workers[victim]->deques[priority].Steal())
+            return task;
+    }
+
+    return nullptr;
+}
+
+bool ThreadPool::TryRunOne()
+{
+    if (t_Pool == this)
+    {
+        Task* task = FindTask(t_WorkerIndex);
+        if (!task)
+            return false;
+        RunTask(task, m_Workers[t_WorkerIndex]->counters, false);
+        return true;
+    }
+
+    thread_local uint32_t t_Rng = 0x9E3779B9u;
+    Task* task = nullptr;
+    for (size_t p = 0; p < PriorityCount && !task; ++p)
+    {
+        if (m_Injection[p].TryPop(task))
+            break;
+        if ((task = StealTask(m_Workers.size(), t_Rng, p)) != nullptr)
+            Count(m_HelperCounters.steals, 1, true);
+    }
+
+    if (!task)
+        return false;
+
+    RunTask(task, m_HelperCounters, true);
+    return true;
+}
+
+bool ThreadPool::HasQueuedTasks() const
+{
+    for (size_t p = 0; p < PriorityCount; ++p)
+    {
+        if (m_Injection[p].Size() > 0)
+            return true;
+        for (const auto& worker : m_Workers)
+            if (!worker->deques[p].Empty())
+                return true;
+    }
+    return false;
+}
+
+void ThreadPool::Execute(Task* task)
+{
+    try
+    {
+        task->execute(task);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "[ThreadPool] Task threw exception: " << e.what() << "\n";
+    }
+}
+
+void ThreadPool::RunTask(Task* task, Counters& counters, bool shared)
+{
+    Count(counters.tasksExecuted, 1, shared);
+    if (!m_Tracing.load(std::memory_order_relaxed))
+    {
+        Execute(task);
+        return;
+    }
+
+    TraceBuffer& trace = LocalTrace();
+    uint64_t begin = NowNs();
+    Execute(task);
+    uint64_t end = NowNs();
+
+    trace.ring.Push({ begin, end });
+}
+
+void ThreadPool::Count(std::atomic<uint64_t>& counter, uint64_t amount, bool shared)
+{
+    if (shared)
+        counter.fetch_add(amount, std::memory_order_relaxed);
+    else
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+void ThreadPool::CountMax(std::atomic<uint64_t>& counter, uint64_t value, bool shared)
+{
+    uint64_t current = counter.load(std::memory_order_relaxed);
+    if (!shared)
+    {
+        if (value > current)
+            counter.store(value, std::memory_order_relaxed);
+        return;
+    }
+    while (value > current && !counter.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+ThreadPool::TraceBuffer& ThreadPool::LocalTrace()
+{
+    // First traced task on this thread: workers keep their index, other
+    // threads are numbered after them
+    return m_TraceBuffers.Local([this]() {
+        uint32_t id = t_Pool == this
+            ? static_cast<uint32_t>(t_WorkerIndex)
+            : static_cast<uint32_t>(m_Workers.size()) + m_NextHelperId++;
+        return std::make_unique<TraceBuffer>(id);
+    });
+}
+
+void ThreadPool::CollectStats(std::vector<WorkerStats>& out)
+{
+    out.resize(m_Workers.size() + 1);
+    for (size_t i = 0; i < out.size(); ++i)
+    {
+        Counters& counters = i < m_Workers.size() ? m_Workers[i]->counters : m_HelperCounters;
+        WorkerStats& last = m_LastStats[i];
+
+        // Running totals: report the difference since last time
+        WorkerStats now;
+        now.tasksExecuted = counters.tasksExecuted.load(std::memory_order_relaxed);
+        now.steals = counters.steals.load(std::memory_order_relaxed);
+        now.idleNs = counters.idleNs.load(std::memory_order_relaxed);
 
-            job = std::move(m_Tasks.front());
-            m_Tasks.pop();
+        out[i].tasksExecuted = now.tasksExecuted - last.tasksExecuted;
+        out[i].steals = now.steals - last.steals;
+        out[i].idleNs = now.idleNs - last.idleNs;
+        out[i].queueHighWater = counters.queueHighWater.exchange(0, std::memory_order_relaxed);
+        last = now;
+    }
+}
+
+void ThreadPool::CollectTrace(std::vector<TraceEvent>& out)
+{
+    m_TraceBuffers.ForEach([&out](TraceBuffer& buffer) {
+        uint32_t thread = buffer.thread;
+        buffer.collected = buffer.ring.ReadSince(buffer.collected, out, [thread](const TraceBuffer::Record& record) {
+            return TraceEvent{ record.beginNs, record.endNs, thread };
+        });
+    });
+}
+
+void ThreadPool::WorkerLoop(size_t index, int cpu)
+{
+    t_Pool = this;
+    t_WorkerIndex = index;
+
+    std::string threadName = m_Name + " " + std::to_string(index);
+    SetCurrentThreadName(threadName);
+    Profiler::SetThreadName(threadName);
+    if (cpu >= 0 && !PinCurrentThread(static_cast<uint32_t>(cpu)))
+        std::cerr << "[ThreadPool] Could not pin " << m_Name << " " << index << " to CPU " << cpu << "\n";
+
+    Counters& counters = m_Workers[index]->counters;
+    uint64_t idleSince = 0;     // 0 while busy
+
+    int idleRounds = 0;
+    while (true)
+    {
+        if (Task* task = FindTask(index))
+        {
+            if (idleSince) {
+                Count(counters.idleNs, NowNs() - idleSince, false);
+                idleSince = 0;
+            }
+            RunTask(task, counters, false);
+            idleRounds = 0;
+            continue;
         }
 
-        try
+        if (!idleSince)
+            idleSince = NowNs();
+
+        if (m_Stop && !HasQueuedTasks())
+            return;
+
+        if (++idleRounds < IdleSpinRounds)
         {
-            job();
+            std::this_thread::yield();
+            continue;
         }
-        catch (const std::exception& e)
+
+        // Announce we are about to sleep, then check once more
+        uint64_t epoch = m_WakeEpoch.load();
+        m_Sleepers.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (!m_Stop && !HasQueuedTasks())
         {
-            std::cerr << "[ThreadPool] Task threw exception: " << e.what() << "\n";
+            std::unique_lock lock(m_SleepMutex);
+            m_Condition.wait(lock, [this, epoch] { return m_WakeEpoch.load() != epoch; });
         }
+
+        m_Sleepers.fetch_sub(1);
+        idleRounds = 0;
     }
 }
 
+std::vector<std::thread::id> ThreadPool::GetWorkerThreadIds() const
+{
+    std::vector<std::thread::id> ids;
+    ids.reserve(m_Workers.size());
+    for (const auto& worker : m_Workers)
+        ids.push_back(worker->thread.get_id());
+    return ids;
+}
+
 size_t ThreadPool::GetQueueSize() const
 {
-    std::scoped_lock lock(m_QueueMutex);
-    return m_Tasks.size();
+    size_t size = 0;
+    for (size_t p = 0; p < PriorityCount; ++p)
+    {
+        size += m_Injection[p].Size();
+        for (const auto& worker : m_Workers)
+            size += worker->deques[p].Size();
+    }
+    return size;
 }
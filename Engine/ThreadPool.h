@@ -1,45 +1,264 @@
 #pragma once
 #include <vector>
 #include <thread>
-#include <queue>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
+#include <string>
+#include <unordered_map>
 #include <atomic>
+#include <cstdint>
 #include <cstddef>
+#include "WorkStealingDeque.h"
+#include "InjectionQueue.h"
+#include "TraceRing.h"
+#include "PerThread.h"
 
 /// <summary>
-/// Fixed-size thread pool for running generic tasks.
+/// Fixed-size work-stealing thread pool for running generic tasks.
 /// Later extended by JobSystem for dependency tracking.
+///
+/// Every worker owns a Chase-Lev deque. Tasks submitted from a worker
+/// go to the bottom of its own deque; tasks submitted from any other
+/// thread go through a lock-free injection queue. An idle worker pops
+/// its own deque, then the injection queue, then steals from the top of
+/// the other workers' deques. Each priority has its own deques and
+/// injection queue; a worker looking for work exhausts every source of
+/// one priority before looking at the next, so a queued High task is
+/// always picked up ahead of Normal and Low ones (tasks are never
+/// preempted once running). Workers with nothing to do spin briefly,
+/// then sleep on a condition variable that submitters only touch when
+/// someone is actually asleep.
+///
+/// Every worker keeps its own counters (tasks run, steals, idle time,
+/// queue high-water mark), written only by that worker, so counting
+/// costs no contention; CollectStats reads them at frame end. Per-task
+/// timestamps are optional (SetTracing) and go to per-thread rings.
 /// </summary>
 class ThreadPool
 {
 public:
+    /// <summary>
+    /// Where the workers may run.
+    /// </summary>
+    enum class Affinity : uint8_t
+    {
+        None,           // the OS schedules freely
+        Cores,          // one logical CPU per worker
+        PhysicalCores,  // one logical CPU per worker, SMT siblings left out
+    };
+
+    struct Config
+    {
+        static constexpr size_t MaxThreadsPerCpu = 4;   // Load caps <prefix>_threads at this many per logical CPU
+
+        size_t threadCount = std::thread::hardware_concurrency();
+        Affinity affinity = Affinity::None;
+        size_t firstCpu = 0;            // worker i gets usable CPU firstCpu + i (wrapping)
+        std::string name = "Worker";    // threads are named "<name> <index>"
+
+        /// <summary>
+        /// Reads <prefix>_threads (0 = one per logical CPU),
+        /// <prefix>_affinity (none / cores / physical), <prefix>_first_cpu
+        /// and <prefix>_name from a loadConfig map; missing or invalid
+        /// keys keep the value from defaults, each on its own. Counts
+        /// must be plain non-negative decimals; threads is capped at
+        /// MaxThreadsPerCpu per logical CPU.
+        /// </summary>
+        static Config Load(const std::unordered_map<std::string, std::string>& values,
+            const std::string& prefix, const Config& defaults);
+        static Config Load(const std::unordered_map<std::string, std::string>& values,
+            const std::string& prefix);
+    };
+
     explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+    explicit ThreadPool(const Config& config);
     ~ThreadPool();
 
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// <summary>
+    /// Shutdown, in three steps the destructor runs in order. Owners of
+    /// several pools whose tasks submit to each other call them
+    /// themselves: Stop every pool, then Join every pool, then Drain
+    /// every pool, so no worker of one is still pushing into another
+    /// that has already emptied its queues.
+    ///
+    /// Stop: no more queueing. Workers finish what is queued and exit;
+    /// tasks submitted from now on run on the submitting thread, so
+    /// nothing waiting on them is left hanging.
+    /// Join: waits for the workers to exit.
+    /// Drain: runs anything still queued on the calling thread (pushes
+    /// that raced with Stop). All three are safe to call again.
+    /// </summary>
+    void Stop();
+    void Join();
+    void Drain();
+
+    /// <summary>
+    /// Order in which queued tasks are picked up, most urgent first.
+    /// </summary>
+    enum class Priority : uint8_t
+    {
+        High,
+        Normal,
+        Low,
+    };
+    static constexpr size_t PriorityCount = 3;
+
+    /// <summary>
+    /// Intrusive unit of work. The pool calls execute(task) once and
+    /// never owns or frees it, so submitting one does not allocate.
+    /// </summary>
+    struct Task
+    {
+        void (*execute)(Task* task) = nullptr;
+    };
+
     /// <summary>
     /// Submit a task for execution.
     /// </summary>
-    void Submit(std::function<void()> task);
+    void Submit(std::function<void()> task, Priority priority = Priority::Normal);
+
+    /// <summary>
+    /// Submit an intrusive task; it must stay alive until it has executed.
+    /// </summary>
+    void Submit(Task* task, Priority priority = Priority::Normal);
+
+    /// <summary>
+    /// Runs one queued task on the calling thread, if there is one.
+    /// Lets a thread that is waiting for results help produce them.
+    /// </summary>
+    bool TryRunOne();
+
+    /// <summary>
+    /// What one thread did between two CollectStats calls.
+    /// </summary>
+    struct WorkerStats
+    {
+        uint64_t tasksExecuted = 0;
+        uint64_t steals = 0;            // tasks taken from another worker's deque
+        uint64_t idleNs = 0;            // spinning or asleep with nothing to run
+        uint64_t queueHighWater = 0;    // deepest its deques got (helpers: the injection queue)
+    };
+
+    /// <summary>
+    /// One executed task; steady_clock time in nanoseconds.
+    /// </summary>
+    struct TraceEvent
+    {
+        uint64_t beginNs = 0;
+        uint64_t endNs = 0;
+        uint32_t thread = 0;            // worker index; other threads are numbered after the workers
+    };
+
+    static constexpr size_t TraceCapacity = 8192;   // events kept per thread between collections
+
+    /// <summary>
+    /// One entry per worker, then one for all other threads that ran
+    /// tasks through TryRunOne. Counts since the previous call; the
+    /// high-water mark is approximate. One caller at a time.
+    /// </summary>
+    void CollectStats(std::vector<WorkerStats>& out);
+
+    /// <summary>
+    /// Records begin/end timestamps of every task while enabled.
+    /// </summary>
+    void SetTracing(bool enabled) { m_Tracing.store(enabled, std::memory_order_relaxed); }
+    [[nodiscard]] bool IsTracing() const { return m_Tracing.load(std::memory_order_relaxed); }
+
+    /// <summary>
+    /// Appends the events recorded since the previous call. A thread
+    /// that ran more than TraceCapacity tasks in between keeps only its
+    /// latest ones. One caller at a time.
+    /// </summary>
+    void CollectTrace(std::vector<TraceEvent>& out);
 
     /// <summary>
     /// Returns number of worker threads.
     /// </summary>
     [[nodiscard]] size_t GetThreadCount() const noexcept { return m_Workers.size(); }
 
+    /// <summary>
+    /// Thread ids of the workers, in worker order.
+    /// </summary>
+    [[nodiscard]] std::vector<std::thread::id> GetWorkerThreadIds() const;
+
     /// <summary>
     /// Returns approximate queue length (for profiling overlay).
     /// </summary>
     [[nodiscard]] size_t GetQueueSize() const;
 
 private:
-    void WorkerLoop();
+    // Heap-allocated wrapper behind Submit(std::function); frees itself
+    struct FunctionTask : Task
+    {
+        std::function<void()> function;
+    };
+
+    // Owner-written counters: a worker updates its own with plain
+    // load/store; the shared helper set uses fetch_add
+    struct Counters
+    {
+        std::atomic<uint64_t> tasksExecuted{ 0 };
+        std::atomic<uint64_t> steals{ 0 };
+        std::atomic<uint64_t> idleNs{ 0 };
+        std::atomic<uint64_t> queueHighWater{ 0 };
+    };
+
+    // One thread's task timestamps
+    struct TraceBuffer
+    {
+        struct Record
+        {
+            uint64_t beginNs;
+            uint64_t endNs;
+        };
+
+        explicit TraceBuffer(uint32_t id) : thread(id) {}
+
+        TraceRing<Record, TraceCapacity> ring;
+        uint64_t collected = 0;            // CollectTrace's cursor
+        uint32_t thread;
+    };
+
+    struct Worker
+    {
+        WorkStealingDeque<Task*> deques[PriorityCount];   // indexed by Priority
+        uint32_t rng = 0;              // victim selection
+        std::thread thread;
+        alignas(64) Counters counters;
+    };
+
+    void Push(Task* task, Priority priority);
+    void WorkerLoop(size_t index, int cpu);
+    Task* FindTask(size_t index);
+    Task* StealTask(size_t skip, uint32_t& rng, size_t priority);
+    bool HasQueuedTasks() const;
+    void Execute(Task* task);
+    void RunTask(Task* task, Counters& counters, bool shared);
+    TraceBuffer& LocalTrace();
+    static void Count(std::atomic<uint64_t>& counter, uint64_t amount, bool shared);
+    static void CountMax(std::atomic<uint64_t>& counter, uint64_t value, bool shared);
+    void WakeOne();
+
+    std::vector<std::unique_ptr<Worker>> m_Workers;
+    std::string m_Name;
 
-    std::vector<std::thread> m_Workers;
-    std::queue<std::function<void()>> m_Tasks;
+    // Stats and tracing
+    Counters m_HelperCounters;          // threads that are not workers
+    std::vector<WorkerStats> m_LastStats;
+    std::atomic<bool> m_Tracing{ false };
+    PerThread<TraceBuffer> m_TraceBuffers;   // one per thread that ran a traced task
+    uint32_t m_NextHelperId = 0;            // only touched while m_TraceBuffers creates an entry
+    InjectionQueue<Task*> m_Injection[PriorityCount];
 
-    mutable std::mutex m_QueueMutex;
+    // Sleep / wake: m_WakeEpoch changes whenever a sleeper should recheck
+    std::mutex m_SleepMutex;
     std::condition_variable m_Condition;
+    std::atomic<uint64_t> m_WakeEpoch{ 0 };
+    std::atomic<uint32_t> m_Sleepers{ 0 };
     std::atomic<bool> m_Stop{ false };
 };
@@ -0,0 +1,107 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+/// <summary>
+/// Fixed-size ring of records written by one thread and read by others.
+///
+/// The owner overwrites the oldest record once Capacity are held and
+/// never waits for readers. Records are copied in and out a word at a
+/// time through relaxed atomics; a reader that raced with the owner
+/// reusing a slot cannot tell from the words alone, so ReadSince checks
+/// the head again afterwards and drops every slot that may have been
+/// rewritten while it copied. The profiler's zones and the thread
+/// pool's task trace both keep one of these per thread.
+/// </summary>
+template<typename T, size_t Capacity>
+class TraceRing
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Records are copied word by word");
+    static_assert(Capacity > 0);
+
+public:
+    TraceRing() : m_Slots(new Slot[Capacity]) {}
+
+    TraceRing(const TraceRing&) = delete;
+    TraceRing& operator=(const TraceRing&) = delete;
+
+    /// <summary>
+    /// Owner thread only. Fills the next slot, then publishes it.
+    /// </summary>
+    void Push(const T& record)
+    {
+        uint64_t words[WordCount] = {};
+        std::memcpy(words, &record, sizeof(T));
+
+        uint64_t head = m_Head.load(std::memory_order_relaxed);
+        Slot& slot = m_Slots[head % Capacity];
+
+        // Pairs with the fence in ReadSince: a reader that sees any word
+        // written below also sees the head published by the last Push,
+        // so it knows this slot is being reused
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WordCount; ++i)
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        m_Head.store(head + 1, std::memory_order_release);
+    }
+
+    /// <summary>
+    /// Records ever pushed; usable as a cursor for ReadSince.
+    /// </summary>
+    [[nodiscard]] uint64_t Head() const { return m_Head.load(std::memory_order_acquire); }
+
+    /// <summary>
+    /// Appends convert(record) to out for each record pushed since the
+    /// cursor 'from' that is still intact, oldest first, and returns the
+    /// cursor to pass next time. Records the owner has overwritten,
+    /// before or during the copy, are skipped. Any thread.
+    /// </summary>
+    template<typename U, typename Convert>
+    uint64_t ReadSince(uint64_t from, std::vector<U>& out, Convert&& convert) const
+    {
+        uint64_t head = m_Head.load(std::memory_order_acquire);
+        uint64_t first = std::max(from, head > Capacity ? head - Capacity : 0);
+        size_t start = out.size();
+
+        for (uint64_t i = first; i < head; ++i)
+        {
+            const Slot& slot = m_Slots[i % Capacity];
+            uint64_t words[WordCount];
+            for (size_t w = 0; w < WordCount; ++w)
+                words[w] = slot.words[w].load(std::memory_order_relaxed);
+
+            T record;
+            std::memcpy(&record, words, sizeof(T));
+            out.push_back(convert(record));
+        }
+
+        // Slots the owner reused while we copied (including the one it
+        // may be writing now) can be torn: drop them. The fence keeps the
+        // head load below from being satisfied before the copies above.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = m_Head.load(std::memory_order_relaxed) + 1;
+        if (after > Capacity && after - Capacity > first)
+        {
+            size_t torn = static_cast<size_t>(std::min(after - Capacity, head) - first);
+            out.erase(out.begin() + start, out.begin() + start + torn);
+        }
+        return head;
+    }
+
+private:
+    static constexpr size_t WordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Slot
+    {
+        std::atomic<uint64_t> words[WordCount];
+    };
+
+    std::unique_ptr<Slot[]> m_Slots;
+    std::atomic<uint64_t> m_Head{ 0 };
+};
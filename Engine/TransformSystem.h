@@ -1,6 +1,7 @@
 #pragma once
 #include "../Engine/ECS/ComponentManager.h"
 #include "../Engine/JobSystem.h"
+#include "../Engine/Core/Memory/FrameArena.h"
 #include "../Engine/Math/MathTypes.h"
 
 struct TransformComponent {
@@ -11,20 +12,30 @@ struct TransformComponent {
 };
 
 //Parallel update of transforms
+//
+//Only transforms inserted or marked changed at sinceTick or later are
+//recomputed (0 = all). Returns the tick to pass on the next call.
+//The changed set is gathered first, into the calling thread's frame
+//arena, so it can be split into chunks; callers on different threads
+//(or nested in a job) never share it.
 class TransformSystem {
 public:
-    static void Update(ComponentManager& cm, JobSystem& js) {
-        auto& transforms = cm.GetAll<TransformComponent>();
+    static uint32_t Update(ComponentManager& cm, JobSystem& js, FrameArena& arena, uint32_t sinceTick = 0) {
+        size_t count = 0;
+        cm.ForEachChangedSince<TransformComponent>(sinceTick, [&](Entity, TransformComponent&) { ++count; });
 
-        Job* root = js.CreateJob([]() {});
-        for (size_t i = 0; i < transforms.size(); ++i) {
-            TransformComponent* t = &transforms[i];
-            Job* job = js.CreateJob([t]() {
+        std::span<TransformComponent*> changed = arena.AllocateArray<TransformComponent*>(count);
+        size_t gathered = 0;
+        cm.ForEachChangedSince<TransformComponent>(sinceTick, [&](Entity, TransformComponent& transform) {
+            changed[gathered++] = &transform;
+            });
+
+        js.ParallelFor(0, gathered, 0, [changed](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                TransformComponent* t = changed[i];
                 t->worldMatrix = Mat4::FromTRS(t->position, t->rotation, t->scale);
-                }, root);
-            js.Run(job);
-        }
-        js.Run(root);
-        js.Wait(root);
+            }
+            });
+        return cm.GetTick();
     }
 };
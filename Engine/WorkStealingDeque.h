@@ -0,0 +1,145 @@
+#pragma once
+#include <atomic>
+#include <type_traits>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+/// <summary>
+/// Chase-Lev work-stealing deque of pointers (Le, Pop, Cohen and
+/// Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak
+/// Memory Models", 2013).
+///
+/// One owner thread pushes and pops at the bottom (LIFO, cache-warm);
+/// any thread may steal from the top (FIFO, oldest work first). Only a
+/// pop or steal racing for the last item touches a CAS.
+///
+/// The ring doubles when full. Retired rings are kept until the deque
+/// is destroyed because a thief may still be reading from one.
+/// </summary>
+template<typename T>
+class WorkStealingDeque
+{
+    static_assert(std::is_pointer<T>::value, "WorkStealingDeque stores pointers");
+
+public:
+    explicit WorkStealingDeque(int64_t capacity = 1024)
+    {
+        assert(capacity >= 2 && (capacity & (capacity - 1)) == 0 && "capacity must be a power of two!");
+        m_Rings.push_back(std::make_unique<Ring>(capacity));
+        m_Ring.store(m_Rings.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /// <summary>
+    /// Owner thread only.
+    /// </summary>
+    void Push(T item)
+    {
+        int64_t b = m_Bottom.load(std::memory_order_relaxed);
+        int64_t t = m_Top.load(std::memory_order_acquire);
+        Ring* ring = m_Ring.load(std::memory_order_relaxed);
+
+        if (b - t > ring->capacity - 1)
+        {
+            m_Rings.push_back(ring->Grow(t, b));
+            ring = m_Rings.back().get();
+            m_Ring.store(ring, std::memory_order_release);
+        }
+
+        ring->Store(b, item);
+        m_Bottom.store(b + 1, std::memory_order_release);   // publishes the item to thieves
+    }
+
+    /// <summary>
+    /// Owner thread only. Returns nullptr when empty.
+    /// </summary>
+    T Pop()
+    {
+        int64_t b = m_Bottom.load(std::memory_order_relaxed) - 1;
+        Ring* ring = m_Ring.load(std::memory_order_relaxed);
+        m_Bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = m_Top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            m_Bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T item = ring->Load(b);
+        if (t == b)
+        {
+            // Last item: race the thieves for it
+            if (!m_Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                item = nullptr;
+            m_Bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /// <summary>
+    /// Any thread. Returns nullptr when empty or when another thread won the race.
+    /// </summary>
+    T Steal()
+    {
+        int64_t t = m_Top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = m_Bottom.load(std::memory_order_acquire);
+
+        if (t >= b)
+            return nullptr;
+
+        Ring* ring = m_Ring.load(std::memory_order_acquire);
+        T item = ring->Load(t);
+        if (!m_Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return item;
+    }
+
+    /// <summary>
+    /// Approximate item count (exact only when no one else is touching the deque).
+    /// </summary>
+    [[nodiscard]] size_t Size() const
+    {
+        int64_t b = m_Bottom.load(std::memory_order_relaxed);
+        int64_t t = m_Top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    [[nodiscard]] bool Empty() const { return Size() == 0; }
+
+private:
+    struct Ring
+    {
+        int64_t capacity;
+        int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Ring(int64_t cap)
+            : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[static_cast<size_t>(cap)])
+        {
+        }
+
+        T Load(int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+        void Store(int64_t i, T item) { slots[i & mask].store(item, std::memory_order_relaxed); }
+
+        std::unique_ptr<Ring> Grow(int64_t top, int64_t bottom) const
+        {
+            auto bigger = std::make_unique<Ring>(capacity * 2);
+            for (int64_t i = top; i < bottom; ++i)
+                bigger->Store(i, Load(i));
+            return bigger;
+        }
+    };
+
+    alignas(64) std::atomic<int64_t> m_Top{ 0 };
+    alignas(64) std::atomic<int64_t> m_Bottom{ 0 };
+    std::atomic<Ring*> m_Ring{ nullptr };
+    std::vector<std::unique_ptr<Ring>> m_Rings;   // current ring is last; owner thread only
+};
@@ -0,0 +1,405 @@
+// AllocatorAlignmentTests.cpp : checks that every allocator honours
+// allocate(size, alignment) for alignments 1..4096, that the bytes it
+// skips show up as padding in AllocatorStats, that the typed
+// New/NewArray helpers construct properly aligned objects, that
+// ConcurrentPoolAllocator never hands one block to two threads, and
+// that SlabAllocator gives empty slabs back to the OS.
+//
+
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "../Engine/DummyAllocator.h"
+#include "../Engine/Core/Memory/LinearAllocator.h"
+#include "../Engine/Core/Memory/StackAllocator.h"
+#include "../Engine/Core/Memory/PoolAllocator.h"
+#include "../Engine/Core/Memory/ConcurrentPoolAllocator.h"
+#include "../Engine/Core/Memory/SlabAllocator.h"
+#include "AllocatorAlignmentTests.h"
+
+namespace
+{
+    constexpr size_t MaxAlignment = 4096;
+
+    bool isAligned(const void* ptr, size_t alignment)
+    {
+        return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+    }
+
+    // Linear and Stack: a 1-byte allocation knocks the cursor off every
+    // boundary before each aligned request, so every request needs
+    // padding and the stats have to account for all of it
+    template<typename BumpAllocator>
+    bool testBumpAllocator()
+    {
+        bool ok = true;
+        for (size_t alignment = 1; alignment <= MaxAlignment; alignment *= 2) {
+            BumpAllocator alloc(64 * 1024);
+            char* start = static_cast<char*>(alloc.allocate(1, 1));
+            char* end = start + 1;
+            size_t requested = 1;
+
+            for (size_t size : { 1, 3, 24, 100 }) {
+                char* ptr = static_cast<char*>(alloc.allocate(size, alignment));
+                if (!ptr || !isAligned(ptr, alignment) || ptr < end) {
+                    ok = false;
+                    break;
+                }
+                std::memset(ptr, 0xAB, size);
+
+                char* odd = static_cast<char*>(alloc.allocate(1, 1));
+                ok = ok && odd == ptr + size;
+                end = odd + 1;
+                requested += size + 1;
+            }
+
+            AllocatorStats stats = alloc.getStats();
+            size_t used = static_cast<size_t>(end - start);
+            ok = ok && stats.totalAllocated == requested
+                && stats.paddingBytes == used - requested
+                && stats.peakUsage == used
+                && stats.allocationCount == 9;
+
+            alloc.reset();
+            stats = alloc.getStats();
+            ok = ok && stats.totalAllocated == 0 && stats.paddingBytes == 0;
+        }
+
+        // Out of room once padding is counted: refused, stats untouched
+        BumpAllocator small(100);
+        small.allocate(1, 1);
+        AllocatorStats before = small.getStats();
+        ok = ok && small.allocate(99, 64) == nullptr
+            && small.getStats().totalAllocated == before.totalAllocated
+            && small.getStats().paddingBytes == before.paddingBytes;
+
+        return ok;
+    }
+
+    bool testStackMarkerRestoresPadding()
+    {
+        StackAllocator alloc(64 * 1024);
+        alloc.allocate(3, 1);
+        AllocatorStats before = alloc.getStats();
+
+        StackMarker marker = alloc.getMarker();
+        void* ptr = alloc.allocate(16, 256);
+        bool padded = ptr && isAligned(ptr, 256) && alloc.getStats().paddingBytes > before.paddingBytes;
+        alloc.freeToMarker(marker);
+
+        AllocatorStats after = alloc.getStats();
+        return padded && after.totalAllocated == before.totalAllocated && after.paddingBytes == before.paddingBytes;
+    }
+
+    // Pool: blocks are aligned to the pool's alignment and spaced by the
+    // block size rounded up to it; stronger requests are refused
+    bool testPoolAllocator()
+    {
+        constexpr size_t BlockSize = 24;
+        constexpr size_t NumBlocks = 8;
+
+        bool ok = true;
+        for (size_t alignment = 1; alignment <= MaxAlignment; alignment *= 2) {
+            PoolAllocator pool(BlockSize, NumBlocks, alignment);
+            size_t blockAlignment = std::max(alignment, alignof(void*));
+            size_t stride = (BlockSize + blockAlignment - 1) / blockAlignment * blockAlignment;
+
+            std::vector<void*> blocks;
+            for (size_t i = 0; i < NumBlocks; ++i) {
+                void* ptr = pool.allocate(BlockSize, alignment);
+                if (!ptr || !isAligned(ptr, alignment)) {
+                    ok = false;
+                    break;
+                }
+                std::memset(ptr, 0xCD, BlockSize);
+                blocks.push_back(ptr);
+            }
+
+            AllocatorStats stats = pool.getStats();
+            ok = ok && pool.allocate(BlockSize, alignment) == nullptr
+                && stats.totalAllocated == NumBlocks * BlockSize
+                && stats.paddingBytes == NumBlocks * (stride - BlockSize);
+
+            for (void* ptr : blocks)
+                pool.deallocate(ptr);
+            stats = pool.getStats();
+            ok = ok && stats.totalAllocated == 0 && stats.paddingBytes == 0
+                && pool.allocate(BlockSize, blockAlignment * 2) == nullptr;
+        }
+        return ok;
+    }
+
+    bool testConcurrentPoolAlignment()
+    {
+        constexpr size_t BlockSize = 24;
+        constexpr size_t NumBlocks = 100;
+
+        bool ok = true;
+        for (size_t alignment = 1; alignment <= MaxAlignment; alignment *= 2) {
+            ConcurrentPoolAllocator pool(BlockSize, NumBlocks, alignment);
+            size_t blockAlignment = std::max(alignment, alignof(void*));
+            size_t stride = (BlockSize + blockAlignment - 1) / blockAlignment * blockAlignment;
+
+            std::vector<void*> blocks;
+            for (size_t i = 0; i < NumBlocks; ++i) {
+                void* ptr = pool.allocate(BlockSize, alignment);
+                if (!ptr || !isAligned(ptr, alignment)) {
+                    ok = false;
+                    break;
+                }
+                std::memset(ptr, 0xCD, BlockSize);
+                blocks.push_back(ptr);
+            }
+
+            AllocatorStats stats = pool.getStats();
+            ok = ok && pool.allocate(BlockSize, alignment) == nullptr
+                && stats.totalAllocated == NumBlocks * BlockSize
+                && stats.paddingBytes == NumBlocks * (stride - BlockSize)
+                && stats.allocationCount == NumBlocks;
+
+            for (void* ptr : blocks)
+                pool.deallocate(ptr);
+            stats = pool.getStats();
+            ok = ok && stats.totalAllocated == 0 && stats.paddingBytes == 0
+                && pool.allocate(BlockSize, blockAlignment * 2) == nullptr;
+        }
+        return ok;
+    }
+
+    // Threads allocate, stamp each block with their id, check the stamp
+    // survived, and hand half of their blocks to the next thread to free,
+    // so blocks keep crossing between caches and the shared list
+    bool testConcurrentPoolThreads()
+    {
+        constexpr size_t Threads = 8;
+        constexpr size_t Rounds = 2000;
+        constexpr size_t PerRound = 40;
+
+        ConcurrentPoolAllocator pool(sizeof(uint64_t), Threads * (PerRound + ConcurrentPoolAllocator::CacheCapacity) * 2);
+        std::atomic<bool> corrupted{ false };
+        std::atomic<size_t> failed{ 0 };
+
+        // Per thread: blocks the previous thread left for it to free
+        std::vector<std::atomic<void**>> handoff(Threads);
+        for (auto& slot : handoff)
+            slot.store(nullptr);
+
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < Threads; ++t) {
+            threads.emplace_back([&, t]() {
+                std::vector<uint64_t*> mine;
+                for (size_t round = 0; round < Rounds; ++round) {
+                    uint64_t stamp = (uint64_t(t) << 32) | round;
+                    for (size_t i = 0; i < PerRound; ++i) {
+                        auto* block = static_cast<uint64_t*>(pool.allocate(sizeof(uint64_t)));
+                        if (!block) {
+                            failed.fetch_add(1);
+                            continue;
+                        }
+                        *block = stamp;
+                        mine.push_back(block);
+                    }
+                    std::this_thread::yield();
+                    for (uint64_t* block : mine)
+                        if (*block != stamp)
+                            corrupted = true;
+
+                    // Keep half, free half; what was left for us gets freed here
+                    size_t keep = mine.size() / 2;
+                    void** list = static_cast<void**>(pool.allocate(sizeof(uint64_t)));
+                    if (list) {
+                        // A tiny linked list through the blocks themselves
+                        void* head = nullptr;
+                        for (size_t i = keep; i < mine.size(); ++i) {
+                            *reinterpret_cast<void**>(mine[i]) = head;
+                            head = mine[i];
+                        }
+                        *list = head;
+                        mine.resize(keep);
+                        if (void** previous = handoff[(t + 1) % Threads].exchange(list)) {
+                            // The neighbour has not collected the last one yet: free it ourselves
+                            for (void* p = *previous; p; ) {
+                                void* next = *static_cast<void**>(p);
+                                pool.deallocate(p);
+                                p = next;
+                            }
+                            pool.deallocate(previous);
+                        }
+                    }
+                    if (void** given = handoff[t].exchange(nullptr)) {
+                        for (void* p = *given; p; ) {
+                            void* next = *static_cast<void**>(p);
+                            pool.deallocate(p);
+                            p = next;
+                        }
+                        pool.deallocate(given);
+                    }
+                    for (uint64_t* block : mine)
+                        pool.deallocate(block);
+                    mine.clear();
+                }
+                pool.flushThreadCache();
+                });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        for (auto& slot : handoff) {
+            if (void** given = slot.exchange(nullptr)) {
+                for (void* p = *given; p; ) {
+                    void* next = *static_cast<void**>(p);
+                    pool.deallocate(p);
+                    p = next;
+                }
+                pool.deallocate(given);
+            }
+        }
+        pool.flushThreadCache();
+
+        return !corrupted && failed == 0 && pool.getStats().totalAllocated == 0;
+    }
+
+    // Slab: every class and the large path, at every alignment; stats
+    // count whole class sizes
+    bool testSlabAllocator()
+    {
+        SlabAllocator alloc;
+        bool ok = true;
+        std::vector<void*> blocks;
+        size_t expected = 0;
+
+        for (size_t alignment = 1; alignment <= MaxAlignment; alignment *= 2) {
+            for (size_t size : { 1, 16, 40, 100, 1000, 3000, 4096, 10000 }) {
+                char* ptr = static_cast<char*>(alloc.allocate(size, alignment));
+                if (!ptr || !isAligned(ptr, alignment)) {
+                    ok = false;
+                    continue;
+                }
+                std::memset(ptr, 0x5A, size);
+                blocks.push_back(ptr);
+
+                size_t classSize = SlabAllocator::classSizeFor(size);
+                expected += classSize ? classSize : size;
+            }
+        }
+
+        ok = ok && alloc.getStats().totalAllocated >= expected
+            && SlabAllocator::classSizeFor(40) == 48
+            && SlabAllocator::classSizeFor(4097) == 0;
+
+        for (void* ptr : blocks)
+            alloc.deallocate(ptr);
+        return ok && alloc.getStats().totalAllocated == 0;
+    }
+
+    // Filling a class maps slab after slab; freeing it all unmaps all
+    // but the one empty slab the class keeps
+    bool testSlabReturnsPages()
+    {
+        SlabAllocator alloc(1);
+        std::vector<void*> blocks;
+        for (size_t i = 0; i < 10000; ++i)
+            blocks.push_back(alloc.allocate(64));
+
+        bool ok = std::find(blocks.begin(), blocks.end(), nullptr) == blocks.end()
+            && alloc.getMappedBytes() >= 10000 * 64;
+
+        for (void* ptr : blocks)
+            alloc.deallocate(ptr);
+        ok = ok && alloc.getMappedBytes() == SlabAllocator::SlabBytes;
+
+        alloc.reset();
+        return ok && alloc.getMappedBytes() == 0;
+    }
+
+    bool testDummyAllocator()
+    {
+        DummyAllocator alloc;
+        bool ok = true;
+        for (size_t alignment = 1; alignment <= MaxAlignment; alignment *= 2) {
+            void* ptr = alloc.allocate(100, alignment);
+            ok = ok && ptr && isAligned(ptr, alignment);
+            if (ptr) {
+                std::memset(ptr, 0xEF, 100);
+                alloc.deallocate(ptr);
+            }
+        }
+        return ok;
+    }
+
+    struct alignas(64) CacheLine {
+        explicit CacheLine(int t) : tag(t) {}
+        float values[15] = {};
+        int tag;
+    };
+
+    struct alignas(32) Vec8 {
+        float lanes[8];
+    };
+
+    struct Tracked {
+        static inline int alive = 0;
+        Tracked() { ++alive; }
+        ~Tracked() { --alive; }
+    };
+
+    bool testTypedHelpers()
+    {
+        LinearAllocator linear(4096);
+        linear.allocate(1, 1);
+        CacheLine* line = linear.New<CacheLine>(7);
+        Vec8* vectors = linear.NewArray<Vec8>(10);
+        bool linearOk = line && isAligned(line, alignof(CacheLine)) && line->tag == 7
+            && vectors && isAligned(vectors, alignof(Vec8))
+            && linear.NewArray<Vec8>(1000) == nullptr;
+
+        PoolAllocator pool(sizeof(CacheLine), 4, alignof(CacheLine));
+        CacheLine* pooled = pool.New<CacheLine>(3);
+        bool poolOk = pooled && isAligned(pooled, alignof(CacheLine)) && pooled->tag == 3;
+        pool.Delete(pooled);
+        poolOk = poolOk && pool.getStats().totalAllocated == 0;
+
+        DummyAllocator dummy;
+        Tracked* tracked = dummy.NewArray<Tracked>(5);
+        bool constructed = Tracked::alive == 5;
+        dummy.DeleteArray(tracked, 5);
+
+        return linearOk && poolOk && constructed && Tracked::alive == 0;
+    }
+}
+
+void RunAllocatorAlignmentTests()
+{
+    std::cout << "Allocator alignment tests:\n";
+    bool passed = testBumpAllocator<LinearAllocator>();
+    std::cout << "  LinearAllocator aligned 1..4096: " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testBumpAllocator<StackAllocator>() && testStackMarkerRestoresPadding();
+    std::cout << "  StackAllocator aligned 1..4096: " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testPoolAllocator();
+    std::cout << "  PoolAllocator aligned 1..4096: " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testConcurrentPoolAlignment();
+    std::cout << "  ConcurrentPoolAllocator aligned 1..4096: " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testConcurrentPoolThreads();
+    std::cout << "  ConcurrentPoolAllocator shared by 8 threads: " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testSlabAllocator();
+    std::cout << "  SlabAllocator aligned 1..4096: " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testSlabReturnsPages();
+    std::cout << "  SlabAllocator returns empty slabs: " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testDummyAllocator();
+    std::cout << "  DummyAllocator aligned 1..4096: " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testTypedHelpers();
+    std::cout << "  New/NewArray helpers: " << (passed ? "PASS" : "FAIL") << "\n";
+}
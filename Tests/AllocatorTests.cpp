@@ -6,14 +6,25 @@
 #include <chrono>
 #include <fstream>
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
 
 
 #include "../Engine/DummyAllocator.h"
 #include "../Engine/Core/Memory/LinearAllocator.h"
 #include "../Engine/Core/Memory/StackAllocator.h"
 #include "../Engine/Core/Memory/PoolAllocator.h"
+#include "../Engine/Core/Memory/ConcurrentPoolAllocator.h"
+#include "../Engine/Core/Memory/SlabAllocator.h"
 #include "../Engine/ConfigReader.h"
 #include "AllocatorTests.h"
+#include "ECSBenchmarks.h"
+#include "ThreadPoolBenchmarks.h"
+#include "JobSystemTests.h"
+#include "AllocatorAlignmentTests.h"
+#include "LuaBenchmarks.h"
 
 //void testAllocator()
 //{
@@ -88,6 +99,9 @@ Allocator* createAllocator(const std::unordered_map<std::string, std::string>& c
         size_t numBlocks = std::stoull(config.at("num_blocks"));
         return new PoolAllocator(blockSize, numBlocks);
     }
+    else if (type == "Slab") {
+        return new SlabAllocator();
+    }
     else {
         return new DummyAllocator();
     }
@@ -133,6 +147,14 @@ std::string autoSelectAllocator() {
         }
         });
 
+    results["Slab"] = benchmark([&]() {
+        SlabAllocator alloc;
+        for (size_t i = 0; i < NUM_ALLOCS; ++i) {
+            void* p = alloc.allocate(BLOCK_SIZE);
+            alloc.deallocate(p);
+        }
+        });
+
     results["Dummy"] = benchmark([&]() {
         DummyAllocator alloc;
         for (size_t i = 0; i < NUM_ALLOCS; ++i) {
@@ -193,6 +215,16 @@ std::vector<std::tuple<std::string, size_t, size_t, long long>> runBenchmarks()
                 });
             results.emplace_back("Pool", block, count, poolTime);
 
+            // Slab (grows on demand, so no up-front size)
+            long long slabTime = benchmark([&]() {
+                SlabAllocator alloc;
+                for (size_t i = 0; i < count; ++i) {
+                    void* p = alloc.allocate(block);
+                    alloc.deallocate(p);
+                }
+                });
+            results.emplace_back("Slab", block, count, slabTime);
+
             // Dummy (malloc/free)
             long long dummyTime = benchmark([&]() {
                 DummyAllocator alloc;
@@ -207,6 +239,90 @@ std::vector<std::tuple<std::string, size_t, size_t, long long>> runBenchmarks()
     return results;
 }
 
+// Every thread allocates a batch of blocks, writes to them and frees
+// them, over and over, all against one shared allocator. The time is
+// from the moment all threads are released until the last one is done.
+template<typename Alloc, typename Free>
+long long benchmarkThreads(size_t threads, size_t opsPerThread, size_t live, Alloc&& alloc, Free&& release) {
+    std::atomic<size_t> ready{ 0 };
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> workers;
+
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            std::vector<void*> blocks(live);
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+
+            for (size_t done = 0; done < opsPerThread; done += live) {
+                for (auto& block : blocks) {
+                    block = alloc();
+                    static_cast<char*>(block)[0] = 1;
+                }
+                for (void* block : blocks)
+                    release(block);
+            }
+            });
+    }
+    while (ready.load() != threads)
+        std::this_thread::yield();
+
+    return benchmark([&]() {
+        go.store(true, std::memory_order_release);
+        for (auto& worker : workers) worker.join();
+        });
+}
+
+// ConcurrentPool against malloc/free and against a PoolAllocator behind
+// a mutex, from 1 to 64 threads
+std::vector<std::tuple<std::string, size_t, size_t, long long>> runConcurrentBenchmarks() {
+    std::vector<std::tuple<std::string, size_t, size_t, long long>> results;
+
+    constexpr size_t BLOCK_SIZE = 32;
+    constexpr size_t LIVE_BLOCKS = 64;
+    constexpr size_t OPS_PER_THREAD = 250000;
+
+    for (size_t threads : { 1, 2, 4, 8, 16, 32, 64 }) {
+        // Each thread can strand a full cache on top of what it holds
+        ConcurrentPoolAllocator concurrent(BLOCK_SIZE, threads * (LIVE_BLOCKS + ConcurrentPoolAllocator::CacheCapacity));
+        results.emplace_back("ConcurrentPool", threads, OPS_PER_THREAD, benchmarkThreads(threads, OPS_PER_THREAD, LIVE_BLOCKS,
+            [&]() { return concurrent.allocate(BLOCK_SIZE); },
+            [&](void* p) { concurrent.deallocate(p); }));
+
+        PoolAllocator pool(BLOCK_SIZE, threads * LIVE_BLOCKS);
+        std::mutex poolMutex;
+        results.emplace_back("LockedPool", threads, OPS_PER_THREAD, benchmarkThreads(threads, OPS_PER_THREAD, LIVE_BLOCKS,
+            [&]() { std::lock_guard<std::mutex> lock(poolMutex); return pool.allocate(BLOCK_SIZE); },
+            [&](void* p) { std::lock_guard<std::mutex> lock(poolMutex); pool.deallocate(p); }));
+
+        // DummyAllocator keeps unsynchronised stats, so call malloc itself
+        results.emplace_back("malloc", threads, OPS_PER_THREAD, benchmarkThreads(threads, OPS_PER_THREAD, LIVE_BLOCKS,
+            [&]() { return std::malloc(BLOCK_SIZE); },
+            [&](void* p) { std::free(p); }));
+    }
+    return results;
+}
+
+void RunConcurrentAllocatorBenchmarks() {
+    auto results = runConcurrentBenchmarks();
+
+    std::cout << "Concurrent allocator benchmark results (32-byte blocks):\n";
+    for (auto& r : results) {
+        std::cout << "  " << std::get<0>(r) << " x" << std::get<1>(r)
+            << " threads: " << std::get<3>(r) << " ms\n";
+    }
+
+    std::ofstream file("concurrent_allocator_benchmarks.csv");
+    file << "Allocator,Threads,OpsPerThread,Time(ms)\n";
+    for (auto& r : results) {
+        file << std::get<0>(r) << ","
+            << std::get<1>(r) << ","
+            << std::get<2>(r) << ","
+            << std::get<3>(r) << "\n";
+    }
+}
+
 #pragma endregion
 
 void saveConfig(const std::string& filename, const std::string& allocator) {
@@ -223,6 +339,19 @@ void saveConfig(const std::string& filename, const std::string& allocator) {
     }
 
 	file << "show_profiler_overlay = true\n";
+    // Per-thread scratch block for frame temporaries
+    file << "frame_arena_kb = 256\n";
+    // Job system threads: 0 = one per logical CPU; affinity none / cores / physical
+    file << "worker_threads = 0\n";
+    file << "worker_affinity = none\n";
+    file << "worker_name = Worker\n";
+    file << "io_threads = 2\n";
+    file << "io_name = IO\n";
+    file << "job_tracing = false\n";
+    // CPU zones for chrome://tracing; spike_ms 0 = write at exit
+    file << "profiler_zones = false\n";
+    file << "profiler_trace_file = profile.json\n";
+    file << "profiler_spike_ms = 0\n";
 }
 
 void runAllocatorTest(Allocator* allocator) {
@@ -255,6 +384,18 @@ int main()
 
     InitConfig();
 
+    RunAllocatorAlignmentTests();
+
+    RunConcurrentAllocatorBenchmarks();
+
+    RunECSBenchmarks();
+
+    RunThreadPoolBenchmarks();
+
+    RunLuaBenchmarks();
+
+    RunJobSystemTests();
+
    // Allocator* allocator = createAllocator(config);
 
    // runAllocatorTest(allocator);
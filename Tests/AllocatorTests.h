@@ -1,3 +1,4 @@
 #pragma once
 
 void InitConfig();
+void RunConcurrentAllocatorBenchmarks();
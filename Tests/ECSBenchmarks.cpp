@@ -0,0 +1,510 @@
+// ECSBenchmarks.cpp : microbenchmarks for the ECS storage layer.
+//
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include <tuple>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <memory>
+
+#include "../Engine/ECS/ComponentArray.h"
+#include "../Engine/ECS/ComponentManager.h"
+#include "../Engine/ECS/EntityManager.h"
+#include "../Engine/ECS/EntityCommandBuffer.h"
+#include "ECSBenchmarks.h"
+
+namespace
+{
+    struct BenchComponent {
+        float position[3] = { 0, 0, 0 };
+        float velocity[3] = { 1, 1, 1 };
+    };
+
+    // The pre-sparse-set ComponentArray, kept here as the comparison baseline
+    template<typename T>
+    class MapComponentArray
+    {
+    public:
+        void InsertData(Entity entity, const T& component) {
+            size_t index = m_Size;
+            m_EntityToIndex[entity.id] = index;
+            if (index >= m_Components.size()) m_Components.resize(index + 1);
+            m_Components[index] = component;
+            m_IndexToEntity[index] = entity.id;
+            ++m_Size;
+        }
+
+        void RemoveData(Entity entity) {
+            size_t removedIndex = m_EntityToIndex[entity.id];
+            size_t lastIndex = m_Size - 1;
+            m_Components[removedIndex] = m_Components[lastIndex];
+            EntityID lastEntity = m_IndexToEntity[lastIndex];
+            m_EntityToIndex[lastEntity] = removedIndex;
+            m_IndexToEntity[removedIndex] = lastEntity;
+            m_EntityToIndex.erase(entity.id);
+            m_IndexToEntity.erase(lastIndex);
+            --m_Size;
+        }
+
+        T& GetData(Entity entity) { return m_Components[m_EntityToIndex[entity.id]]; }
+        bool HasData(Entity entity) const { return m_EntityToIndex.find(entity.id) != m_EntityToIndex.end(); }
+        size_t Size() const { return m_Size; }
+        T& GetAt(size_t index) { return m_Components[index]; }
+        EntityID GetEntityAt(size_t index) { return m_IndexToEntity[index]; }
+
+    private:
+        std::vector<T> m_Components;
+        std::unordered_map<EntityID, size_t> m_EntityToIndex;
+        std::unordered_map<size_t, EntityID> m_IndexToEntity;
+        size_t m_Size = 0;
+    };
+
+    // The pre-ComponentTypeId lookup path: hash on type_index, then a
+    // shared_ptr copy per access. Kept as the per-access baseline.
+    class TypeIndexLookup
+    {
+    public:
+        template<typename T>
+        void Register() { m_Arrays[std::type_index(typeid(T))] = std::make_shared<ComponentArray<T>>(); }
+
+        template<typename T>
+        std::shared_ptr<ComponentArray<T>> GetArray() {
+            return std::static_pointer_cast<ComponentArray<T>>(m_Arrays.at(std::type_index(typeid(T))));
+        }
+
+        template<typename T>
+        T& GetComponent(Entity e) { return GetArray<T>()->GetData(e); }
+
+        template<typename T>
+        bool HasComponent(Entity e) const {
+            auto it = m_Arrays.find(std::type_index(typeid(T)));
+            return it != m_Arrays.end() && static_cast<const ComponentArray<T>*>(it->second.get())->HasData(e);
+        }
+
+    private:
+        std::unordered_map<std::type_index, std::shared_ptr<IComponentArray>> m_Arrays;
+    };
+
+    template<typename Func>
+    long long benchmarkUs(Func&& f) {
+        auto start = std::chrono::high_resolution_clock::now();
+        f();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    }
+
+    using ECSResult = std::tuple<std::string, std::string, size_t, long long>;
+
+    volatile float g_Sink = 0.0f; // keeps the optimizer from discarding reads
+
+    // Runs insert / lookup / iterate / remove against one storage type
+    template<typename Storage>
+    void benchmarkStorage(const std::string& name, size_t count,
+        const std::vector<EntityID>& shuffled, std::vector<ECSResult>& results)
+    {
+        Storage storage;
+        BenchComponent component;
+
+        results.emplace_back(name, "Insert", count, benchmarkUs([&]() {
+            for (size_t i = 0; i < count; ++i)
+                storage.InsertData(Entity{ static_cast<EntityID>(i) }, component);
+            }));
+
+        results.emplace_back(name, "Lookup", count, benchmarkUs([&]() {
+            float sum = 0.0f;
+            for (EntityID id : shuffled) {
+                Entity e{ id };
+                if (storage.HasData(e))
+                    sum += storage.GetData(e).position[0];
+            }
+            g_Sink = sum;
+            }));
+
+        results.emplace_back(name, "Iterate", count, benchmarkUs([&]() {
+            float sum = 0.0f;
+            if constexpr (std::is_same_v<Storage, ComponentArray<BenchComponent>>) {
+                auto& raw = storage.GetRaw();
+                auto& ids = storage.GetEntities();
+                for (size_t i = 0; i < raw.size(); ++i)
+                    sum += raw[i].velocity[1] + static_cast<float>(ids[i]);
+            }
+            else {
+                for (size_t i = 0; i < storage.Size(); ++i)
+                    sum += storage.GetAt(i).velocity[1] + static_cast<float>(storage.GetEntityAt(i));
+            }
+            g_Sink = sum;
+            }));
+
+        results.emplace_back(name, "Remove", count, benchmarkUs([&]() {
+            for (EntityID id : shuffled)
+                storage.RemoveData(Entity{ id });
+            }));
+    }
+
+    struct BenchTag {
+        int value = 1;
+    };
+
+    // Sparse world: 'slots' entity IDs, only 'bodies' of them own both components
+    void benchmarkView(size_t slots, size_t bodies, std::vector<ECSResult>& results)
+    {
+        ComponentManager cm;
+        cm.RegisterComponent<BenchComponent>("BenchComponent");
+        cm.RegisterComponent<BenchTag>("BenchTag");
+
+        size_t stride = slots / bodies;
+        for (size_t i = 0; i < slots; i += stride) {
+            cm.AddComponent(Entity{ static_cast<EntityID>(i) }, BenchComponent{});
+            cm.AddComponent(Entity{ static_cast<EntityID>(i) }, BenchTag{});
+        }
+
+        results.emplace_back("ScanAllIDs", "Query2", slots, benchmarkUs([&]() {
+            float sum = 0.0f;
+            for (size_t id = 0; id < slots; ++id) {
+                Entity e{ static_cast<EntityID>(id) };
+                if (!cm.HasComponent<BenchComponent>(e) || !cm.HasComponent<BenchTag>(e))
+                    continue;
+                sum += cm.GetComponent<BenchComponent>(e).position[0] + cm.GetComponent<BenchTag>(e).value;
+            }
+            g_Sink = sum;
+            }));
+
+        results.emplace_back("View", "Query2", slots, benchmarkUs([&]() {
+            float sum = 0.0f;
+            for (auto [e, component, tag] : cm.View<BenchComponent, BenchTag>())
+                sum += component.position[0] + tag.value;
+            g_Sink = sum;
+            }));
+    }
+
+    struct BenchExtent {
+        float halfExtents[3] = { 0.5f, 0.5f, 0.5f };
+        bool isStatic = false;
+    };
+
+    // Transform + Physics + Collider style iteration over both storage modes
+    void benchmarkStorageMode(const std::string& name, ComponentStorage storage,
+        size_t count, std::vector<ECSResult>& results)
+    {
+        ComponentManager cm(storage);
+        cm.RegisterComponent<BenchComponent>("BenchComponent");
+        cm.RegisterComponent<BenchTag>("BenchTag");
+        cm.RegisterComponent<BenchExtent>("BenchExtent");
+
+        results.emplace_back(name, "Build3", count, benchmarkUs([&]() {
+            for (size_t i = 0; i < count; ++i) {
+                Entity e{ static_cast<EntityID>(i) };
+                cm.AddComponent(e, BenchComponent{});
+                cm.AddComponent(e, BenchExtent{});
+                if (i % 4 != 0)
+                    cm.AddComponent(e, BenchTag{});
+            }
+            }));
+
+        results.emplace_back(name, "Iterate2", count, benchmarkUs([&]() {
+            cm.View<BenchComponent, BenchExtent>().ForEach([](Entity, BenchComponent& c, BenchExtent& x) {
+                for (int axis = 0; axis < 3; ++axis)
+                    c.position[axis] += c.velocity[axis] * 0.016f + x.halfExtents[axis] * 0.0f;
+                });
+            }));
+
+        results.emplace_back(name, "Iterate3", count, benchmarkUs([&]() {
+            float sum = 0.0f;
+            for (auto [e, c, tag, x] : cm.View<BenchComponent, BenchTag, BenchExtent>())
+                sum += c.position[0] + tag.value + x.halfExtents[1];
+            g_Sink = sum;
+            }));
+    }
+
+    // Create / destroy churn on the entity store; reports the store's peak footprint
+    void stressEntityManager(size_t count, std::vector<ECSResult>& results)
+    {
+        EntityManager entities;
+        std::vector<Entity> handles(count);
+        size_t peakBytes = 0;
+        auto samplePeak = [&]() { peakBytes = std::max(peakBytes, entities.GetMemoryUsage()); };
+
+        results.emplace_back("EntityManager", "Create", count, benchmarkUs([&]() {
+            for (size_t i = 0; i < count; ++i)
+                handles[i] = entities.CreateEntity();
+            }));
+        samplePeak();
+
+        std::shuffle(handles.begin(), handles.end(), std::mt19937(99));
+        results.emplace_back("EntityManager", "DestroyShuffled", count, benchmarkUs([&]() {
+            for (Entity e : handles)
+                entities.DestroyEntity(e);
+            }));
+        samplePeak();
+
+        results.emplace_back("EntityManager", "Recreate", count, benchmarkUs([&]() {
+            for (size_t i = 0; i < count; ++i)
+                handles[i] = entities.CreateEntity();
+            }));
+        samplePeak();
+
+        results.emplace_back("EntityManager", "Churn", count, benchmarkUs([&]() {
+            for (size_t i = 0; i < count; i += 2) {
+                entities.DestroyEntity(handles[i]);
+                handles[i] = entities.CreateEntity();
+            }
+            }));
+        samplePeak();
+
+        results.emplace_back("EntityManager", "IterateLiving", count, benchmarkUs([&]() {
+            uint32_t sum = 0;
+            for (Entity e : entities.GetLivingEntities())
+                sum += e.Index();
+            g_Sink = static_cast<float>(sum);
+            }));
+
+        std::cout << "EntityManager stress: " << count << " entities, "
+            << entities.GetCapacity() << " slots, peak memory "
+            << peakBytes / 1024 << " KB\n";
+    }
+
+    // Sparse occupancy: 'live' of 'slots' entities survive. Compares probing a
+    // std::vector<bool> per slot with the bitset scan and the dense list.
+    void benchmarkAliveScan(size_t slots, size_t live, std::vector<ECSResult>& results)
+    {
+        EntityManager entities;
+        std::vector<Entity> handles(slots);
+        for (size_t i = 0; i < slots; ++i)
+            handles[i] = entities.CreateEntity();
+
+        std::shuffle(handles.begin(), handles.end(), std::mt19937(7));
+        for (size_t i = live; i < slots; ++i)
+            entities.DestroyEntity(handles[i]);
+
+        std::vector<bool> alive(slots, false);
+        for (size_t i = 0; i < live; ++i)
+            alive[handles[i].Index()] = true;
+
+        results.emplace_back("EntityManager", "ProbeVectorBool", slots, benchmarkUs([&]() {
+            uint32_t sum = 0;
+            for (uint32_t index = 0; index < slots; ++index)
+                if (alive[index]) sum += index;
+            g_Sink = static_cast<float>(sum);
+            }));
+
+        results.emplace_back("EntityManager", "ForEachAlive", slots, benchmarkUs([&]() {
+            uint32_t sum = 0;
+            entities.ForEachAlive([&](Entity e) { sum += e.Index(); });
+            g_Sink = static_cast<float>(sum);
+            }));
+
+        results.emplace_back("EntityManager", "LivingList", slots, benchmarkUs([&]() {
+            uint32_t sum = 0;
+            for (Entity e : entities.GetLivingEntities())
+                sum += e.Index();
+            g_Sink = static_cast<float>(sum);
+            }));
+    }
+
+    // Spawning 'count' two-component entities directly vs. through a command
+    // buffer (record, then one type-sorted playback). The second round reuses
+    // the buffer's arena, which is the steady-state cost.
+    void benchmarkCommandBuffer(size_t count, std::vector<ECSResult>& results)
+    {
+        auto registerTypes = [](ComponentManager& cm) {
+            cm.RegisterComponent<BenchComponent>("BenchComponent");
+            cm.RegisterComponent<BenchExtent>("BenchExtent");
+        };
+
+        {
+            EntityManager entities;
+            ComponentManager cm;
+            registerTypes(cm);
+            results.emplace_back("CommandBuffer", "Immediate", count, benchmarkUs([&]() {
+                for (size_t i = 0; i < count; ++i) {
+                    Entity e = entities.CreateEntity();
+                    cm.AddComponent(e, BenchComponent{});
+                    cm.AddComponent(e, BenchExtent{});
+                }
+                }));
+        }
+
+        EntityManager entities;
+        ComponentManager cm;
+        registerTypes(cm);
+        EntityCommandBuffer commands;
+
+        for (const char* round : { "RecordCold", "RecordWarm" }) {
+            results.emplace_back("CommandBuffer", round, count, benchmarkUs([&]() {
+                for (size_t i = 0; i < count; ++i) {
+                    DeferredEntity e = commands.CreateEntity();
+                    commands.AddComponent(e, BenchComponent{});
+                    commands.AddComponent(e, BenchExtent{});
+                }
+                }));
+
+            results.emplace_back("CommandBuffer", "Playback", count, benchmarkUs([&]() {
+                commands.Playback(entities, cm);
+                }));
+        }
+    }
+
+    // Scene-load style insertion: one AddComponent per entity vs. one batch
+    void benchmarkBatchInsert(size_t count, std::vector<ECSResult>& results)
+    {
+        std::vector<Entity> owners(count);
+        for (size_t i = 0; i < count; ++i)
+            owners[i] = Entity{ static_cast<EntityID>(i) };
+        std::vector<BenchComponent> components(count);
+
+        {
+            ComponentManager cm;
+            cm.RegisterComponent<BenchComponent>("BenchComponent");
+            results.emplace_back("ComponentManager", "AddComponentLoop", count, benchmarkUs([&]() {
+                for (size_t i = 0; i < count; ++i)
+                    cm.AddComponent(owners[i], components[i]);
+                }));
+        }
+
+        ComponentManager cm;
+        cm.RegisterComponent<BenchComponent>("BenchComponent");
+        results.emplace_back("ComponentManager", "AddComponents", count, benchmarkUs([&]() {
+            cm.AddComponents(owners, components);
+            }));
+    }
+
+    // Per-access cost of GetComponent / HasComponent through each lookup
+    // path; 'accesses' random reads spread over 'count' entities
+    void benchmarkComponentLookup(size_t count, size_t accesses, std::vector<ECSResult>& results)
+    {
+        TypeIndexLookup legacy;
+        legacy.Register<BenchComponent>();
+        legacy.Register<BenchTag>();
+
+        ComponentManager cm;
+        cm.RegisterComponent<BenchComponent>("BenchComponent");
+        cm.RegisterComponent<BenchTag>("BenchTag");
+
+        for (size_t i = 0; i < count; ++i) {
+            Entity e{ static_cast<EntityID>(i) };
+            legacy.GetArray<BenchComponent>()->InsertData(e, BenchComponent{});
+            cm.AddComponent(e, BenchComponent{});
+        }
+
+        std::vector<Entity> order(accesses);
+        std::mt19937 rng(42);
+        for (Entity& e : order)
+            e = Entity{ static_cast<EntityID>(rng() % count) };
+
+        results.emplace_back("TypeIndexMap", "GetComponent", accesses, benchmarkUs([&]() {
+            float sum = 0.0f;
+            for (Entity e : order)
+                sum += legacy.GetComponent<BenchComponent>(e).position[0];
+            g_Sink = sum;
+            }));
+
+        results.emplace_back("ComponentTypeId", "GetComponent", accesses, benchmarkUs([&]() {
+            float sum = 0.0f;
+            for (Entity e : order)
+                sum += cm.GetComponent<BenchComponent>(e).position[0];
+            g_Sink = sum;
+            }));
+
+        results.emplace_back("TypeIndexMap", "HasComponent", accesses, benchmarkUs([&]() {
+            int hits = 0;
+            for (Entity e : order)
+                hits += legacy.HasComponent<BenchComponent>(e) + legacy.HasComponent<BenchTag>(e);
+            g_Sink = static_cast<float>(hits);
+            }));
+
+        results.emplace_back("ComponentTypeId", "HasComponent", accesses, benchmarkUs([&]() {
+            int hits = 0;
+            for (Entity e : order)
+                hits += cm.HasComponent<BenchComponent>(e) + cm.HasComponent<BenchTag>(e);
+            g_Sink = static_cast<float>(hits);
+            }));
+    }
+
+    // Per-frame derived-data pass over every component vs. only the ones
+    // marked changed this tick ('moved' of 'count' touched per frame)
+    void benchmarkChangeTracking(size_t count, size_t moved, std::vector<ECSResult>& results)
+    {
+        ComponentManager cm;
+        cm.RegisterComponent<BenchComponent>("BenchComponent");
+        for (size_t i = 0; i < count; ++i)
+            cm.AddComponent(Entity{ static_cast<EntityID>(i) }, BenchComponent{});
+
+        auto derive = [](Entity, BenchComponent& c) {
+            for (int k = 0; k < 3; ++k)
+                c.velocity[k] = c.position[k] * 0.5f + 1.0f;
+        };
+
+        cm.AdvanceTick();
+        uint32_t since = cm.GetTick();
+        std::mt19937 rng(7);
+        for (size_t i = 0; i < moved; ++i) {
+            Entity e{ static_cast<EntityID>(rng() % count) };
+            cm.GetComponent<BenchComponent>(e).position[0] += 1.0f;
+            cm.MarkChanged<BenchComponent>(e);
+        }
+
+        results.emplace_back("ChangeTracking", "FullRecompute", count, benchmarkUs([&]() {
+            for (auto [e, c] : cm.View<BenchComponent>())
+                derive(e, c);
+            }));
+
+        results.emplace_back("ChangeTracking", "ChangedOnly", count, benchmarkUs([&]() {
+            cm.ForEachChangedSince<BenchComponent>(since, derive);
+            }));
+    }
+
+    void saveECSBenchmarkCSV(const std::string& filename, const std::vector<ECSResult>& results) {
+        std::ofstream file(filename);
+        file << "Storage,Operation,EntityCount,Time(us)\n";
+        for (auto& r : results) {
+            file << std::get<0>(r) << ","
+                << std::get<1>(r) << ","
+                << std::get<2>(r) << ","
+                << std::get<3>(r) << "\n";
+        }
+    }
+}
+
+void RunECSBenchmarks()
+{
+    std::vector<ECSResult> results;
+    const std::vector<size_t> entityCounts = { 1000, 100000, 1000000 };
+
+    for (size_t count : entityCounts) {
+        std::vector<EntityID> shuffled(count);
+        for (size_t i = 0; i < count; ++i) shuffled[i] = static_cast<EntityID>(i);
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(1234));
+
+        benchmarkStorage<MapComponentArray<BenchComponent>>("UnorderedMap", count, shuffled, results);
+        benchmarkStorage<ComponentArray<BenchComponent>>("SparseSet", count, shuffled, results);
+    }
+
+    benchmarkView(1000000, 5000, results);
+
+    for (size_t count : { size_t(100000), size_t(1000000) }) {
+        benchmarkStorageMode("SparseSetStorage", ComponentStorage::SparseSet, count, results);
+        benchmarkStorageMode("ArchetypeStorage", ComponentStorage::Archetype, count, results);
+    }
+
+    stressEntityManager(1000000, results);
+    benchmarkAliveScan(1000000, 50000, results);
+    benchmarkCommandBuffer(100000, results);
+    benchmarkBatchInsert(200000, results);
+    benchmarkComponentLookup(100000, 1000000, results);
+    benchmarkChangeTracking(1000000, 10000, results);
+
+    std::cout << "ECS storage benchmark results:\n";
+    for (auto& r : results) {
+        std::cout << "  " << std::get<0>(r) << " " << std::get<1>(r)
+            << " x" << std::get<2>(r) << ": " << std::get<3>(r) << " us\n";
+    }
+
+    saveECSBenchmarkCSV("ecs_benchmarks.csv", results);
+}
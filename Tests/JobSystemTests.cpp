@@ -0,0 +1,486 @@
+// JobSystemTests.cpp : checks that creating and running jobs does not
+// touch the heap once the per-thread job pools are warm, that frame
+// jobs keep their latency while the loader is flooded, that Task
+// coroutines resume with the right results, that thread settings
+// from engine.cfg are applied, that worker stats and traces add up,
+// that profiler zones end up in the Chrome trace, that the frame
+// arena keeps one frame's scratch alive through the next, and that
+// shutting down runs every job already queued.
+//
+
+#include <iostream>
+#include <atomic>
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <fstream>
+#include <sstream>
+
+#include "../Engine/JobSystem.h"
+#include "../Engine/AsyncLoader.h"
+#include "../Engine/Task.h"
+#include "../Engine/ThreadAffinity.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/Core/Memory/FrameArena.h"
+#include "../Engine/Core/Memory/HeapCounter.h"
+#include "JobSystemTests.h"
+
+namespace
+{
+    // One frame's worth of job traffic: a root with many small children
+    // (freed on worker threads, returned to the creating thread's pool)
+    // and a ParallelFor, whose splits are created on the workers
+    void runJobRound(JobSystem& js, std::atomic<size_t>& sink)
+    {
+        Job* root = js.CreateJob([]() {});
+        for (size_t i = 0; i < 500; ++i) {
+            js.Run(js.CreateJob([&sink, i]() {
+                sink.fetch_add(i & 1, std::memory_order_relaxed);
+                }, root));
+        }
+        js.Wait(js.Run(root));
+
+        js.ParallelFor(0, 10000, 64, [&sink](size_t first, size_t last) {
+            sink.fetch_add(last - first, std::memory_order_relaxed);
+            });
+    }
+
+    bool testSteadyStateJobAllocations()
+    {
+        JobSystem js(4);
+        std::atomic<size_t> sink{ 0 };
+
+        // Warm up: job pools, deque rings and thread caches
+        for (int i = 0; i < 20; ++i)
+            runJobRound(js, sink);
+
+        size_t before = HeapAllocationCount();
+        for (int i = 0; i < 200; ++i)
+            runJobRound(js, sink);
+        size_t allocations = HeapAllocationCount() - before;
+
+        std::cout << "  Heap allocations over 200 steady-state job rounds: " << allocations << "\n";
+        return allocations == 0;
+    }
+
+    // Queues far more loads than there are I/O threads, then runs frames
+    // while they are in flight. Besides a ParallelFor, each frame fans out
+    // one job per thread that waits until all of them have started, so
+    // the frame only completes once every worker has picked one up: if
+    // loads were holding workers, it would run into the timeout.
+    bool testFrameLatencyUnderLoadFlood()
+    {
+        using clock = std::chrono::high_resolution_clock;
+        constexpr double FrameBudgetMs = 20.0;   // a load alone sleeps 100-300 ms
+
+        JobSystem js(4);
+        AsyncLoader loader(js);
+        for (int i = 0; i < 16; ++i)
+            loader.RequestLoad("Flood_" + std::to_string(i));
+        loader.Update();
+
+        std::vector<float> values(100000, 1.0f);
+        const int fanOut = static_cast<int>(js.GetThreadCount()) + 1;   // workers plus the caller
+        double worstMs = 0.0;
+        int frames = 0;
+
+        for (; frames < 30 && loader.GetPendingLoads() > 0; ++frames)
+        {
+            auto start = clock::now();
+
+            js.ParallelFor(0, values.size(), 0, [&values](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i)
+                    values[i] = values[i] * 0.5f + 1.0f;
+                });
+
+            std::atomic<int> started{ 0 };
+            Job* root = js.CreateJob([]() {});
+            for (int i = 0; i < fanOut; ++i) {
+                js.Run(js.CreateJob([&started, fanOut, start]() {
+                    started.fetch_add(1);
+                    while (started.load() < fanOut && clock::now() - start < std::chrono::milliseconds(100))
+                        std::this_thread::yield();
+                    }, root), JobPriority::Frame);
+            }
+            js.Wait(js.Run(root, JobPriority::Frame));
+
+            double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+            worstMs = std::max(worstMs, ms);
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));   // rest of the frame
+        }
+
+        // Only meaningful if the loads were still running the whole time
+        bool flooded = frames == 30 && loader.GetPendingLoads() > 0;
+
+        std::cout << "  Worst frame over " << frames << " frames with " << loader.GetPendingLoads()
+            << " loads pending: " << worstMs << " ms (budget " << FrameBudgetMs << " ms)\n";
+        return flooded && worstMs < FrameBudgetMs;
+    }
+
+    // Polls like the main loop does; false if the task takes too long
+    template<typename T>
+    bool waitReady(const Task<T>& task)
+    {
+        auto start = std::chrono::steady_clock::now();
+        while (!task.IsReady()) {
+            if (std::chrono::steady_clock::now() - start > std::chrono::seconds(10))
+                return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    Task<int> doubleOnWorker(JobSystem& js, int value)
+    {
+        co_await Schedule(js);
+        co_return value * 2;
+    }
+
+    Task<void> failOnWorker(JobSystem& js)
+    {
+        co_await Schedule(js);
+        throw std::runtime_error("task failed");
+    }
+
+    // Every kind of co_await once: nested tasks, an I/O call, and a job
+    // whose children must all have finished before we resume
+    Task<int> pipeline(JobSystem& js)
+    {
+        int a = co_await doubleOnWorker(js, 1);
+        int b = co_await doubleOnWorker(js, 20);
+        int c = co_await RunIO(js, []() { return 300; });
+
+        std::atomic<int> children{ 0 };
+        Job* parent = js.CreateJob([]() {});
+        for (int i = 0; i < 16; ++i)
+            js.Run(js.CreateJob([&children]() { children.fetch_add(1); }, parent));
+        co_await RunJob(js, parent);
+
+        bool threw = false;
+        try {
+            co_await failOnWorker(js);
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+
+        co_return a + b + c + children.load() * 1000 + (threw ? 10000 : 0);
+    }
+
+    bool testTaskPipeline()
+    {
+        JobSystem js(4);
+        bool passed = true;
+
+        for (int i = 0; i < 100 && passed; ++i) {
+            Task<int> task = pipeline(js);
+            task.Start(js);
+            passed = waitReady(task) && task.Result() == 2 + 40 + 300 + 16000 + 10000;
+        }
+
+        Task<void> failing = failOnWorker(js);
+        failing.Start(js);
+        bool rethrown = false;
+        if (waitReady(failing)) {
+            try { failing.Result(); }
+            catch (const std::runtime_error&) { rethrown = true; }
+        }
+
+        return passed && rethrown;
+    }
+
+    bool testLoaderCompletes()
+    {
+        JobSystem js(4);
+        AsyncLoader loader(js);
+        // Sizes that do not split evenly into the decode slices too
+        const size_t sizes[] = { AsyncLoader::DefaultSimulatedBytes, AsyncLoader::DefaultSimulatedBytes + 3, 5, 3, 1, 4097 };
+        for (int i = 0; i < 6; ++i)
+            loader.RequestLoad("Asset_" + std::to_string(i), sizes[i]);
+
+        std::vector<LoadedAsset> loaded;
+        auto start = std::chrono::steady_clock::now();
+        while (loaded.size() < 6 && std::chrono::steady_clock::now() - start < std::chrono::seconds(10)) {
+            loader.Update();
+            for (LoadedAsset& asset : loader.TakeCompleted())
+                loaded.push_back(std::move(asset));
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        // Decoded: every byte is the simulated file byte xor 0x5A
+        bool decoded = loaded.size() == 6;
+        for (const LoadedAsset& asset : loaded)
+            decoded = decoded && asset.data.size() == sizes[asset.name.back() - '0']
+                && std::all_of(asset.data.begin(), asset.data.end(),
+                    [&](uint8_t byte) { return byte == (static_cast<uint8_t>(asset.name.size()) ^ 0x5A); });
+        return decoded && loader.GetPendingLoads() == 0;
+    }
+
+    bool testWorkerStatsAndTrace()
+    {
+        JobSystem js(4);
+        std::vector<ThreadPool::WorkerStats> stats;
+        std::vector<ThreadPool::TraceEvent> trace;
+        js.CollectStats(stats);     // start a fresh window
+        js.SetTracing(true);
+
+        std::atomic<size_t> sink{ 0 };
+        runJobRound(js, sink);
+
+        // A finished job's bookkeeping lands just after Wait returns
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        js.SetTracing(false);
+        js.CollectStats(stats);
+        js.CollectTrace(trace);
+
+        uint64_t executed = 0;
+        for (const auto& worker : stats)
+            executed += worker.tasksExecuted;
+
+        bool ordered = std::all_of(trace.begin(), trace.end(), [&](const ThreadPool::TraceEvent& event) {
+            return event.beginNs <= event.endNs && event.thread <= js.GetThreadCount();
+            });
+
+        // Counters restart with every collection
+        std::vector<ThreadPool::WorkerStats> again;
+        js.CollectStats(again);
+        bool reset = std::all_of(again.begin(), again.end(), [](const ThreadPool::WorkerStats& worker) {
+            return worker.tasksExecuted == 0 && worker.steals == 0;
+            });
+
+        std::cout << "  One job round: " << executed << " tasks, " << trace.size() << " traced\n";
+        return stats.size() == js.GetThreadCount() + 1 && executed > 500
+            && trace.size() == executed && ordered && reset;
+    }
+
+    bool testThreadConfig()
+    {
+        std::unordered_map<std::string, std::string> values{
+            { "worker_threads", "3" },
+            { "worker_affinity", "physical" },
+            { "worker_name", "Physics" },
+            { "io_affinity", "sideways" },   // invalid: keeps the default
+        };
+
+        ThreadPool::Config ioDefaults;
+        ioDefaults.threadCount = 2;
+        ioDefaults.name = "IO";
+
+        ThreadPool::Config workers = ThreadPool::Config::Load(values, "worker");
+        ThreadPool::Config io = ThreadPool::Config::Load(values, "io", ioDefaults);
+        bool parsed = workers.threadCount == 3 && workers.affinity == ThreadPool::Affinity::PhysicalCores
+            && workers.name == "Physics" && io.threadCount == 2 && io.affinity == ThreadPool::Affinity::None;
+
+        // Bad counts keep the default, and only for their own key; huge ones are capped
+        std::unordered_map<std::string, std::string> bad{
+            { "negative_threads", "-1" },
+            { "trailing_threads", "8abc" },
+            { "mixed_threads", "lots" },
+            { "mixed_first_cpu", "2" },
+            { "huge_threads", "100000" },
+        };
+        size_t cap = std::max<size_t>(std::thread::hardware_concurrency(), 1) * ThreadPool::Config::MaxThreadsPerCpu;
+        bool rejected = ThreadPool::Config::Load(bad, "negative", ioDefaults).threadCount == 2
+            && ThreadPool::Config::Load(bad, "trailing", ioDefaults).threadCount == 2;
+        ThreadPool::Config mixed = ThreadPool::Config::Load(bad, "mixed", ioDefaults);
+        rejected = rejected && mixed.threadCount == 2 && mixed.firstCpu == 2
+            && ThreadPool::Config::Load(bad, "huge").threadCount == cap;
+
+        std::vector<uint32_t> logical = GetUsableCpus(false);
+        std::vector<uint32_t> physical = GetUsableCpus(true);
+        bool topology = !physical.empty() && physical.size() <= logical.size();
+
+        // Pinned workers still share out the work
+        JobSystem js(workers, io);
+        std::atomic<size_t> sum{ 0 };
+        js.ParallelFor(0, 100000, 0, [&sum](size_t first, size_t last) {
+            sum.fetch_add(last - first, std::memory_order_relaxed);
+            });
+
+        std::cout << "  Usable CPUs: " << logical.size() << " logical, " << physical.size() << " physical\n";
+        return parsed && rejected && topology && sum.load() == 100000;
+    }
+
+    size_t countOccurrences(const std::string& text, const std::string& pattern)
+    {
+        size_t count = 0;
+        for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1))
+            ++count;
+        return count;
+    }
+
+    bool testProfilerTrace()
+    {
+        const std::string path = "profiler_test.json";
+        constexpr size_t JobCount = 64;
+
+        JobSystem js(3, 1);
+        Profiler::Clear();
+        Profiler::SetEnabled(true);
+        {
+            PROFILE_ZONE("TestFrame");
+            Job* root = js.CreateJob([]() {});
+            for (size_t i = 0; i < JobCount; ++i) {
+                js.Run(js.CreateJob([]() {
+                    PROFILE_ZONE("TestZone");
+                    }, root));
+            }
+            js.Wait(js.Run(root));
+        }
+        Profiler::SetEnabled(false);
+
+        // Recorded while disabled: must not show up
+        {
+            PROFILE_ZONE("TestDisabled");
+        }
+
+        bool written = Profiler::WriteChromeTrace(path);
+        std::ifstream file(path);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        file.close();
+        std::remove(path.c_str());
+
+        const std::string json = contents.str();
+        size_t zones = countOccurrences(json, "\"name\":\"TestZone\"");
+        size_t jobs = countOccurrences(json, "\"name\":\"Job\"");
+
+        std::cout << "  Trace: " << zones << " test zones, " << jobs << " job zones\n";
+        return written && json.find("\"traceEvents\"") != std::string::npos
+            && zones == JobCount && jobs >= JobCount + 1
+            && countOccurrences(json, "\"name\":\"TestFrame\"") == 1
+            && json.find("TestDisabled") == std::string::npos
+            && json.find("\"thread_name\"") != std::string::npos;
+    }
+
+
+    bool testFrameArena()
+    {
+        constexpr size_t Slices = 16;
+        constexpr size_t SliceLength = 300;     // 16 x 1.2 KB: several blocks per frame
+        constexpr uint32_t Frames = 40;
+
+        // Jobs fill scratch arrays on whichever thread runs them; the
+        // previous frame's arrays must come through this frame intact
+        JobSystem js(4, 1);
+        FrameArena arena(4 * 1024);
+        std::vector<std::span<uint32_t>> previous(Slices), current(Slices);
+        bool intact = true;
+
+        for (uint32_t frame = 0; frame < Frames; ++frame) {
+            arena.BeginFrame();
+            js.ParallelFor(0, Slices, 1, [&arena, &current, frame](size_t first, size_t last) {
+                for (size_t s = first; s < last; ++s) {
+                    std::span<uint32_t> values = arena.AllocateArray<uint32_t>(SliceLength);
+                    std::fill(values.begin(), values.end(), frame * 1000 + static_cast<uint32_t>(s));
+                    current[s] = values;
+                }
+                });
+
+            for (size_t s = 0; frame > 0 && s < Slices; ++s) {
+                uint32_t expected = (frame - 1) * 1000 + static_cast<uint32_t>(s);
+                intact = intact && std::all_of(previous[s].begin(), previous[s].end(),
+                    [expected](uint32_t value) { return value == expected; });
+            }
+            std::swap(previous, current);
+        }
+
+        // One thread: memory comes back two frames later, and once the
+        // blocks exist a frame costs no heap allocations
+        FrameArena local(4 * 1024);
+        local.BeginFrame();
+        void* first = local.Allocate(64, 64);
+        local.BeginFrame();
+        void* second = local.Allocate(64, 64);
+        bool doubleBuffered = first != second && reinterpret_cast<uintptr_t>(second) % 64 == 0;
+
+        size_t heapBefore = 0;
+        for (int frame = 0; frame < 10; ++frame) {
+            if (frame == 2)
+                heapBefore = HeapAllocationCount();
+            local.BeginFrame();
+            void* reused = local.Allocate(64, 64);
+            doubleBuffered = doubleBuffered && reused == (frame % 2 == 0 ? first : second);
+            for (size_t i = 0; i < 10; ++i)
+                local.AllocateArray<float>(1000);   // overflows into extra blocks
+        }
+        size_t heapAllocations = HeapAllocationCount() - heapBefore;
+
+        FrameArena::Stats stats = local.GetStats();
+        std::cout << "  Frame arena: " << stats.usedBytes << " bytes used in the last frame, "
+            << heapAllocations << " heap allocations once warm\n";
+        return intact && doubleBuffered && heapAllocations == 0
+            && stats.usedBytes == 64 + 10 * 1000 * sizeof(float) && stats.threads == 1;
+    }
+
+    // Destroys a JobSystem while chains that hop between the frame
+    // workers and the I/O lane are still in flight: every link must
+    // still run. Then a task submitted to a stopped pool must run too.
+    bool testShutdownRunsQueuedJobs()
+    {
+        constexpr int Chains = 200;
+        constexpr int Links = 6;
+        std::atomic<int> ran{ 0 };
+        {
+            JobSystem js(4, 2);
+            for (int c = 0; c < Chains; ++c) {
+                Job* links[Links];
+                for (int i = 0; i < Links; ++i)
+                    links[i] = js.CreateJob([&ran]() {
+                        std::this_thread::sleep_for(std::chrono::microseconds(50));
+                        ran.fetch_add(1);
+                        });
+                for (int i = 1; i < Links; ++i)
+                    js.AddDependency(links[i - 1], links[i]);
+                for (int i = Links - 1; i >= 0; --i)
+                    (i % 2 ? js.RunIO(links[i]) : js.Run(links[i]));
+            }
+        }
+
+        ThreadPool pool(2);
+        pool.Stop();
+        bool ranInline = false;
+        pool.Submit([&ranInline]() { ranInline = true; });
+
+        std::cout << "  Links run across shutdown: " << ran.load() << " of " << Chains * Links << "\n";
+        return ran.load() == Chains * Links && ranInline;
+    }
+}
+
+void RunJobSystemTests()
+{
+    std::cout << "JobSystem tests:\n";
+    bool passed = testSteadyStateJobAllocations();
+    std::cout << "  Steady-state jobs allocation-free: " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testFrameLatencyUnderLoadFlood();
+    std::cout << "  Frame jobs within budget under load flood: " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testTaskPipeline();
+    std::cout << "  Task awaits (tasks, I/O, jobs, exceptions): " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testLoaderCompletes();
+    std::cout << "  AsyncLoader read -> decode -> ready: " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testWorkerStatsAndTrace();
+    std::cout << "  Worker stats and job trace: " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testThreadConfig();
+    std::cout << "  Thread config from engine.cfg: " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testProfilerTrace();
+    std::cout << "  Profiler zones in Chrome trace: " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testFrameArena();
+    std::cout << "  Frame arena double-buffered, heap-free when warm: " << (passed ? "PASS" : "FAIL") << "\n";
+
+    passed = testShutdownRunsQueuedJobs();
+    std::cout << "  Shutdown runs queued jobs on both lanes: " << (passed ? "PASS" : "FAIL") << "\n";
+}
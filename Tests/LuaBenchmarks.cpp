@@ -0,0 +1,137 @@
+// LuaBenchmarks.cpp : GC-heavy scripts on a state made by luaL_newstate
+// (libc malloc) against one on LuaAllocator's size classes, and a check
+// that LuaAllocator's byte count agrees with Lua's own.
+//
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <vector>
+#include <tuple>
+#include <string>
+#include <limits>
+#include <utility>
+
+#include "../Engine/Scripting/LuaAllocator.h"
+#include "LuaBenchmarks.h"
+
+extern "C"
+{
+#include "../Engine/ThirdParty/lua/include/lua.h"
+#include "../Engine/ThirdParty/lua/include/lauxlib.h"
+#include "../Engine/ThirdParty/lua/include/lualib.h"
+}
+
+namespace
+{
+    // Short-lived tables and closures, with a rolling window kept alive
+    // so the collector has old objects to trace as well as garbage
+    const char* TableChurnScript = R"(
+        local live = {}
+        local sum = 0
+        for i = 1, 200000 do
+            local v = { x = i, y = i * 0.5, tag = i % 7 }
+            live[i % 512 + 1] = v
+            local f = function() return v.x + v.y end
+            sum = sum + f()
+        end
+        return sum
+    )";
+
+    // Strings of many sizes, some past the largest size class
+    const char* StringChurnScript = R"(
+        local parts = {}
+        local total = 0
+        for i = 1, 50000 do
+            local s = "entity_" .. i .. string.rep("x", i % 300)
+            parts[i % 64 + 1] = s
+            if i % 1000 == 0 then
+                total = total + #table.concat(parts, ",")
+            end
+        end
+        return total
+    )";
+
+    template<typename Func>
+    long long benchmarkUs(Func&& f) {
+        auto start = std::chrono::high_resolution_clock::now();
+        f();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    }
+
+    // Allocator, scenario, time
+    using LuaResult = std::tuple<std::string, std::string, long long>;
+
+    // Runs the script and returns what it returned, or NaN on error
+    double runScript(lua_State* L, const char* script)
+    {
+        if (luaL_dostring(L, script) != LUA_OK) {
+            std::cout << "  [Lua] " << lua_tostring(L, -1) << "\n";
+            lua_pop(L, 1);
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        double result = lua_tonumber(L, -1);
+        lua_pop(L, 1);
+        return result;
+    }
+
+    size_t luaCountBytes(lua_State* L)
+    {
+        return size_t(lua_gc(L, LUA_GCCOUNT)) * 1024 + size_t(lua_gc(L, LUA_GCCOUNTB));
+    }
+
+    void saveLuaBenchmarkCSV(const std::string& filename, const std::vector<LuaResult>& results) {
+        std::ofstream file(filename);
+        file << "Allocator,Scenario,Time(us)\n";
+        for (auto& r : results) {
+            file << std::get<0>(r) << ","
+                << std::get<1>(r) << ","
+                << std::get<2>(r) << "\n";
+        }
+    }
+}
+
+void RunLuaBenchmarks()
+{
+    std::vector<LuaResult> results;
+    bool sameResults = true;
+    bool accountingMatches = true;
+
+    std::cout << "Lua benchmark results:\n";
+    for (auto [scenario, script] : { std::pair{ "TableChurn", TableChurnScript }, std::pair{ "StringChurn", StringChurnScript } })
+    {
+        lua_State* L = luaL_newstate();
+        luaL_openlibs(L);
+        double expected = 0.0;
+        results.emplace_back("libc", scenario, benchmarkUs([&]() { expected = runScript(L, script); }));
+        lua_close(L);
+
+        LuaAllocator memory;
+        L = memory.NewState();
+        luaL_openlibs(L);
+        double result = 0.0;
+        {
+            LuaAllocator::ScriptScope scope(memory, memory.GetScriptId(scenario));
+            results.emplace_back("LuaAllocator", scenario, benchmarkUs([&]() { result = runScript(L, script); }));
+        }
+        sameResults = sameResults && result == expected;
+
+        lua_gc(L, LUA_GCCOLLECT);
+        LuaAllocator::Stats stats = memory.GetStats();
+        accountingMatches = accountingMatches && stats.liveBytes == luaCountBytes(L);
+
+        const auto& charged = memory.GetScriptStats()[memory.GetScriptId(scenario)];
+        std::cout << "  " << scenario << ": " << charged.allocations << " allocations, "
+            << charged.allocatedBytes / 1024 << " KB charged to the script; after a full collect "
+            << stats.liveBytes / 1024 << " KB live in " << stats.mappedBytes / 1024 << " KB of slabs\n";
+        lua_close(L);
+    }
+
+    for (auto& r : results)
+        std::cout << "  " << std::get<0>(r) << " " << std::get<1>(r) << ": " << std::get<2>(r) << " us\n";
+    std::cout << "  Same script results on both allocators: " << (sameResults ? "PASS" : "FAIL") << "\n";
+    std::cout << "  LuaAllocator live bytes match Lua's count: " << (accountingMatches ? "PASS" : "FAIL") << "\n";
+
+    saveLuaBenchmarkCSV("lua_benchmarks.csv", results);
+}
@@ -0,0 +1,197 @@
+// ThreadPoolBenchmarks.cpp : task throughput of the work-stealing pool
+// against the original single locked queue, under rising thread counts,
+// and JobSystem::ParallelFor against one job per element.
+//
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <vector>
+#include <tuple>
+#include <string>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <thread>
+
+#include "../Engine/ThreadPool.h"
+#include "../Engine/JobSystem.h"
+#include "../Engine/TransformSystem.h"
+#include "ThreadPoolBenchmarks.h"
+
+namespace
+{
+    // The pre-work-stealing ThreadPool, kept here as the comparison baseline
+    class LockedThreadPool
+    {
+    public:
+        explicit LockedThreadPool(size_t threadCount)
+        {
+            for (size_t i = 0; i < threadCount; ++i)
+                m_Workers.emplace_back([this] { WorkerLoop(); });
+        }
+
+        ~LockedThreadPool()
+        {
+            m_Stop = true;
+            m_Condition.notify_all();
+            for (auto& thread : m_Workers)
+                thread.join();
+        }
+
+        void Submit(std::function<void()> task)
+        {
+            {
+                std::scoped_lock lock(m_QueueMutex);
+                m_Tasks.push(std::move(task));
+            }
+            m_Condition.notify_one();
+        }
+
+    private:
+        void WorkerLoop()
+        {
+            while (true)
+            {
+                std::function<void()> job;
+                {
+                    std::unique_lock lock(m_QueueMutex);
+                    m_Condition.wait(lock, [this] { return m_Stop || !m_Tasks.empty(); });
+                    if (m_Stop && m_Tasks.empty())
+                        return;
+                    job = std::move(m_Tasks.front());
+                    m_Tasks.pop();
+                }
+                job();
+            }
+        }
+
+        std::vector<std::thread> m_Workers;
+        std::queue<std::function<void()>> m_Tasks;
+        std::mutex m_QueueMutex;
+        std::condition_variable m_Condition;
+        std::atomic<bool> m_Stop{ false };
+    };
+
+    template<typename Func>
+    long long benchmarkUs(Func&& f) {
+        auto start = std::chrono::high_resolution_clock::now();
+        f();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    }
+
+    // Pool, scenario, worker threads, tasks, time
+    using PoolResult = std::tuple<std::string, std::string, size_t, size_t, long long>;
+
+    // A few hundred nanoseconds of work: the size of one transform update
+    void tinyTask(std::atomic<size_t>& done)
+    {
+        volatile float x = 1.0f;
+        for (int i = 0; i < 64; ++i)
+            x = x * 1.0001f + 0.5f;
+        done.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void waitFor(const std::atomic<size_t>& done, size_t count)
+    {
+        while (done.load(std::memory_order_acquire) < count)
+            std::this_thread::yield();
+    }
+
+    template<typename Pool>
+    void benchmarkPool(const char* name, size_t threads, size_t tasks, std::vector<PoolResult>& results)
+    {
+        Pool pool(threads);
+        std::atomic<size_t> done{ 0 };
+
+        // Every task comes from outside the pool (the main thread)
+        results.emplace_back(name, "ExternalSubmit", threads, tasks, benchmarkUs([&]() {
+            for (size_t i = 0; i < tasks; ++i)
+                pool.Submit([&done] { tinyTask(done); });
+            waitFor(done, tasks);
+            }));
+
+        // One root task per worker fans out the rest from inside the pool
+        done = 0;
+        results.emplace_back(name, "NestedSubmit", threads, tasks, benchmarkUs([&]() {
+            size_t perRoot = tasks / threads;
+            for (size_t r = 0; r < threads; ++r) {
+                pool.Submit([&pool, &done, perRoot] {
+                    for (size_t i = 0; i < perRoot; ++i)
+                        pool.Submit([&done] { tinyTask(done); });
+                    });
+            }
+            waitFor(done, perRoot * threads);
+            }));
+    }
+
+    // World matrices for 'count' transforms: one Job per transform (how
+    // TransformSystem used to do it) vs. chunked ParallelFor
+    void benchmarkParallelFor(size_t threads, size_t count, std::vector<PoolResult>& results)
+    {
+        JobSystem js(threads);
+        std::vector<TransformComponent> transforms(count);
+        for (size_t i = 0; i < count; ++i)
+            transforms[i].position = { float(i), 0.0f, float(i % 7) };
+
+        results.emplace_back("JobSystem", "PerElementJobs", threads, count, benchmarkUs([&]() {
+            std::atomic<size_t> done{ 0 };
+            for (TransformComponent& transform : transforms) {
+                TransformComponent* t = &transform;
+                js.Run(js.CreateJob([t, &done]() {
+                    t->worldMatrix = Mat4::FromTRS(t->position, t->rotation, t->scale);
+                    done.fetch_add(1, std::memory_order_release);
+                    }));
+            }
+            waitFor(done, count);
+            }));
+
+        results.emplace_back("JobSystem", "ParallelFor", threads, count, benchmarkUs([&]() {
+            js.ParallelFor(0, count, 0, [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    TransformComponent& t = transforms[i];
+                    t.worldMatrix = Mat4::FromTRS(t.position, t.rotation, t.scale);
+                }
+                });
+            }));
+    }
+
+    void savePoolBenchmarkCSV(const std::string& filename, const std::vector<PoolResult>& results) {
+        std::ofstream file(filename);
+        file << "Pool,Scenario,Threads,Tasks,Time(us)\n";
+        for (auto& r : results) {
+            file << std::get<0>(r) << ","
+                << std::get<1>(r) << ","
+                << std::get<2>(r) << ","
+                << std::get<3>(r) << ","
+                << std::get<4>(r) << "\n";
+        }
+    }
+}
+
+void RunThreadPoolBenchmarks()
+{
+    std::vector<PoolResult> results;
+    const size_t tasks = 200000;
+
+    for (size_t threads : { 1, 4, 16, 64 }) {
+        benchmarkPool<LockedThreadPool>("LockedQueue", threads, tasks, results);
+        benchmarkPool<ThreadPool>("WorkStealing", threads, tasks, results);
+    }
+
+    for (size_t threads : { 4, 16 })
+        benchmarkParallelFor(threads, 100000, results);
+
+    std::cout << "Thread pool benchmark results:\n";
+    for (auto& r : results) {
+        long long us = std::get<4>(r);
+        std::cout << "  " << std::get<0>(r) << " " << std::get<1>(r)
+            << " threads=" << std::get<2>(r) << " x" << std::get<3>(r) << ": " << us << " us ("
+            << (us > 0 ? std::get<3>(r) * 1000 / us : 0) << " tasks/ms)\n";
+    }
+
+    savePoolBenchmarkCSV("threadpool_benchmarks.csv", results);
+}